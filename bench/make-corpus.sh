@@ -0,0 +1,176 @@
+#!/bin/sh
+# Writes a generated document for timing hatdocs: a main .hat file, *input*
+# files holding the sections, a bib file and a footer.
+#
+# Usage: bench/make-corpus.sh [options] directory
+#
+#   -s sections      top level sections, every other one is a section2 with its subsections on their own pages (default: 100)
+#   -u subsections   subsections of each section (default: 3)
+#   -d depth         depth of the sections, 1 for sections only, 2 with subsections, 3 with subsubsections (default: 2)
+#   -p paragraphs    paragraphs of each section and subsection (default: 4)
+#   -f formulas      $...$ formulas in each paragraph, alternately one word and several words (default: 1)
+#   -t tables        tables of options in each section and subsection (default: 1)
+#   -e examples      *codeexample* blocks in each section and subsection (default: 1)
+#   -i inputs        *input* files the sections are spread over in order, 0 for all in the main file (default: 10)
+#   -c citations     entries in the bib file, cited in turn (default: 200)
+
+sections=100
+subsections=3
+depth=2
+paragraphs=4
+formulas=1
+tables=1
+examples=1
+inputs=10
+citations=200
+
+usage()
+{
+	echo "Usage: $0 [-s sections] [-u subsections] [-d depth] [-p paragraphs] [-f formulas] [-t tables] [-e examples] [-i inputs] [-c citations] directory" >&2
+	exit 1
+}
+
+while getopts "s:u:d:p:f:t:e:i:c:" option; do
+	case $option in
+		s) sections=$OPTARG ;;
+		u) subsections=$OPTARG ;;
+		d) depth=$OPTARG ;;
+		p) paragraphs=$OPTARG ;;
+		f) formulas=$OPTARG ;;
+		t) tables=$OPTARG ;;
+		e) examples=$OPTARG ;;
+		i) inputs=$OPTARG ;;
+		c) citations=$OPTARG ;;
+		*) usage ;;
+	esac
+done
+shift $((OPTIND - 1))
+
+[ $# -eq 1 ] || usage
+
+dir=$1
+mkdir -p "$dir" || exit 1
+rm -f "$dir"/input*.hat
+
+awk -v dir="$dir" -v sections="$sections" -v subsections="$subsections" -v depth="$depth" -v paragraphs="$paragraphs" \
+	-v formulas="$formulas" -v tables="$tables" -v examples="$examples" -v inputs="$inputs" -v citations="$citations" '
+function paragraph(file, s, p,    f, line)
+{
+	print "*" > file
+	print "The program reads the data file and writes the results for each of the options given on the command line." > file
+	print "A *b* bold */b* and *i* italic */i* word, 50*percent* of the *code* --option */code* values and a *q* quote */q* ." > file
+	for(f = 1; f <= formulas; f++)
+	{
+		if(f % 2 == 1) print "The value $x_" f "^2$, is found first." > file
+		else print "Then $a + b_" f " = c$ is found from it." > file
+	}
+	if(citations > 0) print "As shown by *cite* ref" ((s * 7 + p) % citations) " */cite* the method is fast." > file
+	if(s > 1) print "See Section *ref* section" (s - 1) " */ref* for more details." > file
+	print "*" > file
+}
+
+function blocks(file, s,    t, e)
+{
+	for(t = 1; t <= tables; t++)
+	{
+		print (t % 2 == 1 ? "*tableropt*" : "*table*") > file
+		print "*tr* Option & Default & Meaning */tr*" > file
+		print "*tr* -o & . & Output directory */tr*" > file
+		print "*tr* -j & 4 & Number of threads */tr*" > file
+		print "*tr* --gzip-level & 6 & Compression level */tr*" > file
+		print (t % 2 == 1 ? "*/tableropt*" : "*/table*") > file
+	}
+
+	for(e = 1; e <= examples; e++)
+	{
+		print "*codeexample*" > file
+		print "hatdocs -o site" s " -f footer.txt bench.hat bench.bib" > file
+		print "hatdocs --search --minify -j 4 bench.hat" > file
+		print "*/codeexample*" > file
+	}
+}
+
+function part(file, level, name, title, s,    p, u, tag)
+{
+	tag = (level == 2 ? "subsection" : "subsubsection")
+	print "*" tag "*" > file
+	print "*" tag "-name* " name " */" tag "-name*" > file
+	print "*" tag "-title* " title " */" tag "-title*" > file
+	for(p = 1; p <= paragraphs; p++) paragraph(file, s, p)
+	blocks(file, s)
+	if(level < depth)
+	{
+		for(u = 1; u <= subsections; u++) part(file, level + 1, name "-" u, "Part " u " of " title, s)
+	}
+	print "*/" tag "*" > file
+}
+
+BEGIN {
+	main = dir "/bench.hat"
+	print "*title* Generated Benchmark Manual */title*" > main
+	print "*author* hatdocs bench */author*" > main
+	print "*date* 1st January 2020 */date*" > main
+	print "*abstract* A document generated to time the HTML and TeX output. */abstract*" > main
+	print "" > main
+
+	for(s = 1; s <= sections; s++)
+	{
+		file = main
+		if(inputs > 0)
+		{
+			i = int((s - 1) * inputs / sections) + 1
+			file = dir "/input" i ".hat"
+			if(!(i in started))
+			{
+				started[i] = 1
+				print "*input* input" i ".hat */input*" > main
+			}
+		}
+
+		print (s % 2 == 0 ? "*section2*" : "*section*") > file
+		print "*section-name* section" s " */section-name*" > file
+		print "*section-title* Section number " s " */section-title*" > file
+		for(p = 1; p <= paragraphs; p++) paragraph(file, s, p)
+		blocks(file, s)
+
+		if(depth >= 2)
+		{
+			for(u = 1; u <= subsections; u++) part(file, 2, "section" s "-" u, "Subsection " u " of section " s, s)
+		}
+
+		print "*/section*" > file
+		print "" > file
+	}
+
+	for(i in started) close(dir "/input" i ".hat")
+
+	print "" > main
+	print "*webpage*" > main
+	print "*webpage-name* download */webpage-name*" > main
+	print "*webpage-title* Download */webpage-title*" > main
+	print "*" > main
+	print "Download the program from the website." > main
+	print "*" > main
+	print "*/webpage*" > main
+	close(main)
+
+	bib = dir "/bench.bib"
+	for(c = 0; c < citations; c++)
+	{
+		print "@article{ref" c "," > bib
+		print "author = {Author" c ", Anne B. and Writer, Carl and Other, Dan}," > bib
+		print "title = {Title of paper number " c "}," > bib
+		print "journal = {genet}," > bib
+		print "volume = {" (c % 50 + 1) "}," > bib
+		print "pages = {" c "--" (c + 10) "}," > bib
+		print "year = {" (1980 + c % 40) "}" > bib
+		print "}" > bib
+		print "" > bib
+	}
+	close(bib)
+
+	print "<p>Generated benchmark footer</p>" > (dir "/footer.txt")
+}
+'
+
+echo "Written $dir/bench.hat with $sections sections, $dir/bench.bib and $dir/footer.txt"
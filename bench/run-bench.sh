@@ -0,0 +1,115 @@
+#!/bin/sh
+# Times hatdocs on a document made by bench/make-corpus.sh, using the times
+# written with --stats-json. Each case is run a number of times and the
+# fastest and median total times are shown, with the files written by the
+# last run, followed by the median time of each phase. The stats of every
+# run are kept in the output directory.
+#
+# Usage: bench/run-bench.sh [-b hatdocs] [-r runs] [-o output] corpus [hatdocs options]
+#
+# e.g.   bench/make-corpus.sh -s 300 /tmp/corpus
+#        bench/run-bench.sh -b ./hatdocs /tmp/corpus --search --gzip
+
+hatdocs=./hatdocs
+runs=5
+output=bench-output
+
+usage()
+{
+	echo "Usage: $0 [-b hatdocs] [-r runs] [-o output] corpus [hatdocs options]" >&2
+	exit 1
+}
+
+while getopts "b:r:o:" option; do
+	case $option in
+		b) hatdocs=$OPTARG ;;
+		r) runs=$OPTARG ;;
+		o) output=$OPTARG ;;
+		*) usage ;;
+	esac
+done
+shift $((OPTIND - 1))
+
+[ $# -ge 1 ] || usage
+corpus=$1
+shift
+
+[ -f "$corpus/bench.hat" ] || { echo "No document: $corpus/bench.hat, make one with bench/make-corpus.sh" >&2; exit 1; }
+[ -x "$hatdocs" ] || { echo "Cannot run: $hatdocs" >&2; exit 1; }
+
+case $hatdocs in /*) ;; *) hatdocs=$(pwd)/$hatdocs ;; esac
+mkdir -p "$output" || exit 1
+case $output in /*) ;; *) output=$(pwd)/$output ;; esac
+cd "$corpus" || exit 1
+
+# value of a count or the total time from a stats json file
+getStat()
+{
+	sed -n "s/.*\"$1\": \([0-9.]*\).*/\1/p" "$2" | head -n 1
+}
+
+# runs one case a number of times, $1 is the name, $2 is run before each build, the rest are options
+runCase()
+{
+	name=$1
+	prepare=$2
+	shift 2
+
+	times=""
+	run=1
+	while [ $run -le $runs ]; do
+		eval "$prepare"
+		"$hatdocs" -o "$output/pages" -f footer.txt --stats-json "$name-$run.json" "$@" bench.hat bench.bib > /dev/null || { echo "Build failed: $name" >&2; exit 1; }
+		mv "$output/pages/$name-$run.json" "$output/$name-$run.json"
+		times="$times $(getStat total_seconds "$output/$name-$run.json")"
+		run=$((run + 1))
+	done
+
+	last="$output/$name-$runs.json"
+	echo $times | tr ' ' '\n' | sort -n | awk -v name="$name" -v written="$(getStat files_written "$last")" -v unchanged="$(getStat files_unchanged "$last")" \
+		'{t[NR] = $1} END {printf "%-12s %10.4f %10.4f %8d %10d\n", name, t[1], t[int((NR + 1) / 2)], written, unchanged}'
+}
+
+# edits the first paragraph of the first section so that one page and the tex file change, a different edit each run
+editSection()
+{
+	awk -v run="$run" '!edited && /^The program reads the data file/ {sub(/data file( edited [0-9]+)?/, "data file edited " run); edited = 1} {print}' "$output/edited.hat.orig" > "$edited"
+}
+
+# the file with the first section
+edited=bench.hat
+[ -f input1.hat ] && edited=input1.hat
+cp "$edited" "$output/edited.hat.orig"
+trap 'cp "$output/edited.hat.orig" "$edited"; rm -f "$output/edited.hat.orig"' EXIT
+trap 'exit 1' HUP INT TERM PIPE
+
+echo "Document: $corpus/bench.hat, runs: $runs, options: $*"
+printf "%-12s %10s %10s %8s %10s\n" case fastest median written unchanged
+cases="full full-j1 unchanged one-edit forced"
+runCase full "rm -rf '$output/pages'" "$@"
+runCase full-j1 "rm -rf '$output/pages'" -j 1 "$@"
+runCase unchanged ":" "$@"
+runCase one-edit "editSection" "$@"
+runCase forced ":" --full "$@"
+
+# the median seconds of each phase over the runs of each case, with the phases in the order of the json
+echo
+printf "%-22s" phase
+for name in $cases; do printf " %10s" "$name"; done
+echo
+
+for name in $cases; do
+	run=1
+	while [ $run -le $runs ]; do
+		sed -n 's/^ *"\([a-z_]*\)": {"seconds": \([0-9.]*\),.*/\1 \2/p' "$output/$name-$run.json"
+		run=$((run + 1))
+	done > "$output/$name-phases.txt"
+done
+
+for phase in $(awk '{print $1}' "$output/full-phases.txt" | awk '!seen[$1]++'); do
+	printf "%-22s" "$phase"
+	for name in $cases; do
+		awk -v phase="$phase" '$1 == phase {print $2}' "$output/$name-phases.txt" | sort -n | awk '{t[NR] = $1} END {printf " %10.4f", t[int((NR + 1) / 2)]}'
+	done
+	echo
+done
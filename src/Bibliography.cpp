@@ -0,0 +1,514 @@
+/*
+  Richard Howey
+  Research Software Engineering, Newcastle University
+  HAT-DOCS: HTML and TeX documentation from one common source
+*/
+
+#include <sstream>
+#include <iostream>
+#include <fstream>
+#include <list>
+#include <map>
+#include <cstdio>
+#include <sys/stat.h>
+
+using namespace std; // initiates the "std" or "standard" namespace
+
+#include "Bibliography.h"
+#include "HatOutput.h"
+
+const string Bibliography::cacheVersion = "HATBIB1";
+
+//returns the field name of a line such as "author = {...}," or "" if the line is not a field
+string getFieldName(const string & fieldLine, unsigned int & equalPos)
+{
+	unsigned int length = fieldLine.length();
+	unsigned int startPos = 0;
+
+	while(startPos < length && (fieldLine[startPos] == ' ' || fieldLine[startPos] == '\t')) startPos++;
+
+	equalPos = startPos;
+	while(equalPos < length && fieldLine[equalPos] != '=') equalPos++;
+	if(equalPos == length) return "";
+
+	unsigned int endPos = equalPos;
+	while(endPos > startPos && (fieldLine[endPos - 1] == ' ' || fieldLine[endPos - 1] == '\t')) endPos--;
+
+	return fieldLine.substr(startPos, endPos - startPos);
+};
+
+//returns the value of a field given the position of its equal sign, without any braces, commas or spaces at either end
+string getFieldValue(const string & fieldLine, const unsigned int & equalPos)
+{
+	unsigned int length = fieldLine.length();
+	unsigned int startPos = equalPos + 1;
+
+	while(startPos < length && (fieldLine[startPos] == ' ' || fieldLine[startPos] == '{')) startPos++;
+
+	unsigned int endPos = length;
+	while(endPos > startPos && (fieldLine[endPos - 1] == ' ' || fieldLine[endPos - 1] == '}' || fieldLine[endPos - 1] == ','
+		|| fieldLine[endPos - 1] == '\r' || fieldLine[endPos - 1] == '\t')) endPos--;
+
+	return fieldLine.substr(startPos, endPos - startPos);
+};
+
+void changeJournalName(Citation * citation)
+{
+
+	if(citation->journal == "ajhg") citation->journal = "Am J Hum Genet";
+	else if(citation->journal == "ajmg") citation->journal = "Am J  Med Genet";
+	else if(citation->journal == "ajmga") citation->journal = "Am J Med Genet A";
+	else if(citation->journal == "annals") citation->journal = "Ann Hum Genet";             
+	else if(citation->journal == "bmcs") citation->journal = "Biometrics";
+	else if(citation->journal == "bmka") citation->journal = "Biometrika";
+	else if(citation->journal == "ejhg") citation->journal = "Eur J  Hum Genet";
+	else if(citation->journal == "genepi") citation->journal = "Genet Epidemiol";
+	else if(citation->journal == "genom") citation->journal = "Genomics";
+	else if(citation->journal == "genet") citation->journal = "Genetics";
+	else if(citation->journal == "humgen") citation->journal = "Hum Genet";
+	else if(citation->journal == "humher") citation->journal = "Hum Hered";
+	else if(citation->journal == "hummol") citation->journal = "Hum Molec Genet";
+	else if(citation->journal == "jasa") citation->journal = "Journal of the American Statistical Association";
+	else if(citation->journal == "jci") citation->journal = "Journal of Clinical Immunity";
+	else if(citation->journal == "jrssb") citation->journal = "Journal of the Royal Statistical Society, Series B";
+	else if(citation->journal == "lancet") citation->journal = "Lancet";
+	else if(citation->journal == "natgenet") citation->journal = "Nat Genet";
+	else if(citation->journal == "nature") citation->journal = "Nature";
+	else if(citation->journal == "natrevgenet") citation->journal = "Nat Rev Genet";
+	else if(citation->journal == "science") citation->journal = "Science";
+	else if(citation->journal == "statmed") citation->journal = "Statistics in Medicine";
+	else if(citation->journal == "statsci") citation->journal = "Statistical Science";
+	else if(citation->journal == "TPB") citation->journal = "Theoretical Population Biology";
+	
+	if(citation->publisher == "Chapman \\& Hall/CRC") citation->publisher = "Chapman &amp; Hall/CRC";
+	else if(citation->publisher == "Chapman \\& Hall") citation->publisher = "Chapman &amp; Hall";
+	else if(citation->publisher == "Texts in Statistical Science, Chapman \\& Hall/CRC (US)") citation->publisher = "Texts in Statistical Science, Chapman &amp; Hall/CRC (US)";
+	else if(citation->publisher == "Chapman \\& Hall/CRC, London") citation->publisher = "Chapman &amp; Hall/CRC, London";
+	else if(citation->publisher == "John Wiley \\& Sons, New York") citation->publisher = "John Wiley &amp; Sons, New York";
+	
+
+};
+
+void changeAuthorsAndRefName(Citation * citation)
+{
+	string ans;
+	string refName = "";
+	string authors = citation->authors;
+	string orderName = "";
+
+	map<unsigned int, string> listAuthors;
+	unsigned int count = 1;
+
+	//cout << authors << "\n";
+	unsigned int pos = 0;
+	unsigned int lastPos = 0;
+
+	//get all authors of citation, entries such as proceedings may have no authors
+	if(authors.length() >= 5)
+	{
+		do{		
+			if(authors.substr(pos, 5) == " and ")
+			{
+				listAuthors[count] = authors.substr(lastPos, (pos-lastPos + 1));
+				lastPos = pos + 5;
+				count++;
+			};
+				
+			pos++;		
+		}while(pos < (authors.length() - 5));
+	};
+
+	//add the last name
+	listAuthors[count] = authors.substr(lastPos);
+
+	string initials = "";
+	string aInitial;
+	string lastName = "";
+	unsigned int commaPos;
+
+	for(map<unsigned int, string>::const_iterator a = listAuthors.begin(); a != listAuthors.end(); ++a)
+	{
+		//cout << a->first << " " <<a->second <<"\n";
+		lastName = "";
+		initials = "";
+
+		//get the last name and initials
+		//check if there is a comma
+		pos = 0;
+		commaPos = 0;
+		do{
+			if(a->second.substr(pos, 1) == ",")
+			{
+				commaPos = pos;
+				break;
+			};			
+	
+			pos++;
+		}while(pos < a->second.length());
+
+		//if name has comma get last name and initials
+		if(commaPos != 0)
+		{
+			lastName = a->second.substr(0, commaPos);
+
+			pos = commaPos;
+			do{
+				if(a->second.substr(pos, 1) == " " && a->second.substr((pos + 1),1) != " " &&
+					(pos == (a->second.length() - 2) || a->second.substr((pos + 2), 1) == " "))
+				{
+					initials.append(a->second.substr((pos + 1),1));
+					initials.append(". ");
+				}
+				else if( //"J-B"					
+					a->second.substr(pos, 1) == " " && a->second.substr((pos + 1),1) != " " &&
+					a->second.length() - pos >= 3 && a->second.substr((pos + 2), 1) == "-" &&
+					(pos == (a->second.length() - 4) || a->second.substr((pos + 4), 1) == " ")					
+					)
+				{
+					initials.append(a->second.substr((pos + 1),3));
+					initials.append(". ");
+				};
+
+				pos++;
+			}while(pos <= (a->second.length() - 2));
+
+		}
+		else
+		{
+
+			stringstream getNameAndInitials(a->second);
+			list<string> someStrings;
+			char space = ' ';
+			string aString;
+
+			//get initials and last name
+			do{
+				getline(getNameAndInitials, aString, space);
+				someStrings.push_back(aString);				
+			}while(!getNameAndInitials.eof() && getNameAndInitials.good());
+
+			lastName = *(someStrings.rbegin());
+
+			for(list<string>::const_iterator ss = someStrings.begin(); ss != someStrings.end(); )
+			{
+				aString = *ss;
+				ss++;
+				if(ss != someStrings.end())
+				{
+					initials.append(aString);
+					if((aString).size() == 1) initials.append(". ");
+					else initials.append(" ");
+				};
+
+			};
+
+		};
+
+		if(a->first == 1)
+		{
+			orderName.append(lastName);
+			orderName.append(citation->year);
+			refName.append(lastName);
+		};
+
+		if(listAuthors.size() == 2 && a->first == 2)
+		{
+			string secondAuthor = " and " + lastName;
+			refName.append(secondAuthor);
+		};
+
+		if(a->first >1 && a->first == listAuthors.size()) ans.append(" and ");
+		else if(a->first > 1)
+		{
+			if(ans.length() >= 1 && ans.substr(ans.length()-1, 1)==" ") ans = ans.substr(0, ans.length()-1);
+			ans.append(", ");
+		};
+
+		ans.append(initials);
+		ans.append(lastName);
+	};
+
+	
+	if(listAuthors.size() > 2) refName.append(" et al.");
+	refName.append(" (");
+	refName.append(citation->year);
+	refName.append(")");
+	citation->refName = refName;
+	citation->orderName = orderName;
+	citation->authors = ans;
+
+	if(citation->note != "") citation->refName = citation->authors;
+};
+
+//a hash of the contents of a file, used to check a cache is for the same file
+unsigned long long getTextHash(const string & text)
+{
+	unsigned long long hash = 14695981039346656037ULL;
+
+	for(string::const_iterator c = text.begin(); c != text.end(); ++c)
+	{
+		hash ^= (unsigned char)(*c);
+		hash *= 1099511628211ULL;
+	};
+
+	return hash;
+};
+
+void appendNumber(string & cache, const unsigned long long & number)
+{
+	for(unsigned int i = 0; i < 8; ++i) cache.push_back((char)((number >> (8*i)) & 0xff));
+};
+
+void appendString(string & cache, const string & aString)
+{
+	appendNumber(cache, aString.length());
+	cache.append(aString);
+};
+
+void appendCitation(string & cache, const Citation * citation)
+{
+	appendString(cache, citation->name);
+	appendString(cache, citation->title);
+	appendString(cache, citation->authors);
+	appendString(cache, citation->year);
+	appendString(cache, citation->journal);
+	appendString(cache, citation->volume);
+	appendString(cache, citation->number);
+	appendString(cache, citation->pages);
+	appendString(cache, citation->url);
+	appendString(cache, citation->editor);
+	appendString(cache, citation->edition);
+	appendString(cache, citation->publisher);
+	appendString(cache, citation->refName);
+	appendString(cache, citation->orderName);
+	appendString(cache, citation->note);
+};
+
+bool readNumber(const string & cache, size_t & pos, unsigned long long & number)
+{
+	if(pos + 8 > cache.length()) return false;
+
+	number = 0;
+	for(unsigned int i = 0; i < 8; ++i) number |= ((unsigned long long)(unsigned char)cache[pos + i]) << (8*i);
+	pos += 8;
+
+	return true;
+};
+
+bool readString(const string & cache, size_t & pos, string & aString)
+{
+	unsigned long long length;
+	if(!readNumber(cache, pos, length) || pos + length > cache.length()) return false;
+
+	aString.assign(cache, pos, length);
+	pos += length;
+
+	return true;
+};
+
+//read the bibtex file once, splitting every entry into its fields, or use the cache of a previous run if the file has not changed
+bool Bibliography::load(const string & filename)
+{
+	struct stat fileStatus;
+	if(stat(filename.c_str(), &fileStatus) != 0) return false;
+
+	unsigned long long fileSize = fileStatus.st_size;
+	//use the time to the nanosecond where possible as the bib file may be edited more than once in a second
+#ifdef __linux__
+	unsigned long long fileTime = (unsigned long long)fileStatus.st_mtim.tv_sec*1000000000ULL + fileStatus.st_mtim.tv_nsec;
+#else
+	unsigned long long fileTime = fileStatus.st_mtime;
+#endif
+	string cacheFileName = filename + ".hatcache";
+
+	//read the whole cache in one go
+	string cache = "";
+	ifstream fileCacheIn(cacheFileName.c_str(), ios::binary);
+	if(fileCacheIn.is_open())
+	{
+		ostringstream cacheText;
+		cacheText << fileCacheIn.rdbuf();
+		cache = cacheText.str();
+		fileCacheIn.close();
+	};
+
+	string cacheName;
+	unsigned long long cacheSize = 0, cacheTime = 0, cacheHash = 0;
+	size_t pos = cacheVersion.length();
+	bool validCache = cache.compare(0, cacheVersion.length(), cacheVersion) == 0
+		&& readString(cache, pos, cacheName) && readNumber(cache, pos, cacheSize) && readNumber(cache, pos, cacheTime) && readNumber(cache, pos, cacheHash)
+		&& cacheName == filename && cacheSize == fileSize;
+
+	if(validCache && cacheTime == fileTime && readCache(cache, pos)) return true;
+
+	ifstream fileBibIn(filename.c_str());
+	if(!fileBibIn.is_open()) return false;
+
+	ostringstream bibText;
+	bibText << fileBibIn.rdbuf();
+	fileBibIn.close();
+
+	//the file may have been touched without being changed
+	unsigned long long fileHash = getTextHash(bibText.str());
+	if(!(validCache && cacheHash == fileHash && readCache(cache, pos)))
+	{
+		parse(bibText.str());
+	};
+
+	writeCache(cacheFileName, filename, fileSize, fileTime, fileHash);
+
+	return true;
+};
+
+void Bibliography::parse(const string & bibText)
+{
+	istringstream fileBibIn(bibText);
+
+	string aLine, citeName;
+	char returnChar = '\n';
+	list<string> citeLines;
+	bool inEntry = false;
+	unsigned int pos, length, namePos;
+
+	do{
+		getline(fileBibIn, aLine, returnChar);
+
+		if(inEntry)
+		{
+			//an entry ends with a line starting with }
+			if(aLine.length() >= 1 && aLine[0] == '}')
+			{
+				addEntry(citeName, citeLines);
+				inEntry = false;
+			}
+			else citeLines.push_back(aLine);
+
+			continue;
+		};
+
+		//look for the start of an entry, e.g. @article{name,
+		length = aLine.length();
+		pos = 0;
+		while(pos < length && (aLine[pos] == ' ' || aLine[pos] == '\t')) pos++;
+		if(pos == length || aLine[pos] != '@') continue;
+
+		while(pos < length && aLine[pos] != '{') pos++;
+		namePos = pos + 1;
+		pos = namePos;
+		while(pos < length && aLine[pos] != ',' && aLine[pos] != ' ' && aLine[pos] != '\t' && aLine[pos] != '\r') pos++;
+		if(namePos >= length || pos == namePos) continue;
+
+		citeName = aLine.substr(namePos, pos - namePos);
+		citeLines.clear();
+		inEntry = true;
+
+	}while(!fileBibIn.eof() && fileBibIn.good());
+
+	if(inEntry) addEntry(citeName, citeLines);
+};
+
+//read the citations from a cache, with all the fields already split and changed
+bool Bibliography::readCache(const string & cache, size_t & pos)
+{
+	unsigned long long noCitations;
+	if(!readNumber(cache, pos, noCitations)) return false;
+
+	Citation * citation;
+	for(unsigned long long i = 0; i < noCitations; ++i)
+	{
+		citation = new Citation();
+
+		if(!(readString(cache, pos, citation->name) && readString(cache, pos, citation->title) && readString(cache, pos, citation->authors)
+			&& readString(cache, pos, citation->year) && readString(cache, pos, citation->journal) && readString(cache, pos, citation->volume)
+			&& readString(cache, pos, citation->number) && readString(cache, pos, citation->pages) && readString(cache, pos, citation->url)
+			&& readString(cache, pos, citation->editor) && readString(cache, pos, citation->edition) && readString(cache, pos, citation->publisher)
+			&& readString(cache, pos, citation->refName) && readString(cache, pos, citation->orderName) && readString(cache, pos, citation->note)))
+		{
+			//the cache is damaged so start again from the bib file
+			delete citation;
+			for(map<string, Citation *>::iterator c = citations.begin(); c != citations.end(); ++c)
+			{
+				delete c->second;
+			};
+			citations.clear();
+
+			return false;
+		};
+
+		citations[citation->name] = citation;
+	};
+
+	return true;
+};
+
+//write the citations to a cache file for the next run, it does not matter if this fails
+void Bibliography::writeCache(const string & cacheFileName, const string & filename, const unsigned long long & fileSize, const unsigned long long & fileTime, const unsigned long long & fileHash)
+{
+	string cache = cacheVersion;
+	appendString(cache, filename);
+	appendNumber(cache, fileSize);
+	appendNumber(cache, fileTime);
+	appendNumber(cache, fileHash);
+	appendNumber(cache, citations.size());
+
+	for(map<string, Citation *>::const_iterator c = citations.begin(); c != citations.end(); ++c)
+	{
+		appendCitation(cache, c->second);
+	};
+
+	//write to a temporary file first so a part written cache is never read
+	string tempFileName = getTempFileName(cacheFileName);
+	ofstream fileCacheOut(tempFileName.c_str(), ios::binary);
+	if(!fileCacheOut.is_open()) return;
+
+	fileCacheOut.write(cache.data(), cache.length());
+	fileCacheOut.close();
+
+	if(fileCacheOut.fail()) remove(tempFileName.c_str());
+	else renameTempFile(tempFileName, cacheFileName);
+};
+
+void Bibliography::addEntry(const string & citeName, const list<string> & citeLines)
+{
+	//keep the first entry if a name is used twice
+	map<string, Citation *>::const_iterator c = citations.find(citeName);
+	if(c != citations.end()) return;
+
+	Citation * citation = new Citation();
+	citation->name = citeName;
+
+	//add fields of the citation
+	string fieldName;
+	unsigned int equalPos;
+	for(list<string>::const_iterator cl = citeLines.begin(); cl != citeLines.end(); ++cl)
+	{
+		fieldName = getFieldName(*cl, equalPos);
+
+		if(fieldName == "author" || fieldName == "AUTHOR") citation->authors = getFieldValue(*cl, equalPos);
+		else if(fieldName == "title" || fieldName == "TITLE") citation->title = getFieldValue(*cl, equalPos);
+		else if(fieldName == "journal" || fieldName == "JOURNAL") citation->journal = getFieldValue(*cl, equalPos);
+		else if(fieldName == "volume" || fieldName == "VOLUME") citation->volume = getFieldValue(*cl, equalPos);
+		else if(fieldName == "number" || fieldName == "NUMBER") citation->number = getFieldValue(*cl, equalPos);
+		else if(fieldName == "year" || fieldName == "YEAR") citation->year = getFieldValue(*cl, equalPos);
+		else if(fieldName == "url" || fieldName == "URL") citation->url = getFieldValue(*cl, equalPos);
+		else if(fieldName == "pages" || fieldName == "PAGES") citation->pages = getFieldValue(*cl, equalPos);
+		else if(fieldName == "editor" || fieldName == "EDITOR") citation->editor = getFieldValue(*cl, equalPos);
+		else if(fieldName == "edition" || fieldName == "EDITION") citation->edition = getFieldValue(*cl, equalPos);
+		else if(fieldName == "publisher" || fieldName == "PUBLISHER") citation->publisher = getFieldValue(*cl, equalPos);
+		else if(fieldName == "note" || fieldName == "NOTE") citation->note = getFieldValue(*cl, equalPos);
+	};
+
+	changeJournalName(citation);
+	changeAuthorsAndRefName(citation);
+
+	citations[citeName] = citation;
+};
+
+//returns the citation with the given name or 0 if it is not in the bibtex file
+Citation * Bibliography::getCitation(const string & citeName) const
+{
+	map<string, Citation *>::const_iterator c = citations.find(citeName);
+
+	if(c != citations.end()) return c->second;
+	else return 0;
+};
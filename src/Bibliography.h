@@ -0,0 +1,80 @@
+/*
+  Richard Howey
+  Research Software Engineering, Newcastle University
+  HAT-DOCS: HTML and TeX documentation from one common source
+*/
+
+#ifndef __BIBLIOGRAPHY
+#define __BIBLIOGRAPHY
+
+#include <string>
+#include <list>
+#include <map>
+
+//basic class for storing info about a citation
+struct Citation
+{
+	string name;
+	string title;
+	string authors;
+	string year;	
+	string journal;
+	string volume;
+	string number;
+	string pages;
+	string url;
+	string editor;
+	string edition;
+	string publisher;
+	string refName;
+	string orderName;
+	string note;
+
+	~Citation()
+	{
+		
+	};
+
+};
+
+//hashing and storing values for cache files
+unsigned long long getTextHash(const string & text);
+void appendNumber(string & cache, const unsigned long long & number);
+void appendString(string & cache, const string & aString);
+void appendCitation(string & cache, const Citation * citation);
+bool readNumber(const string & cache, size_t & pos, unsigned long long & number);
+bool readString(const string & cache, size_t & pos, string & aString);
+
+//all of the entries of a bibtex file, the file is read once and each entry can be found by its name,
+//the entries are cached in file.bib.hatcache so they need not be parsed again until the bib file changes
+class Bibliography
+{
+private:
+
+	map<string, Citation *> citations; //entry name, citation
+
+	static const string cacheVersion; //start of a cache file, changed if the format changes
+
+	void parse(const string & bibText);
+	bool readCache(const string & cache, size_t & pos);
+	void writeCache(const string & cacheFileName, const string & filename, const unsigned long long & fileSize, const unsigned long long & fileTime, const unsigned long long & fileHash);
+
+public:
+
+	Bibliography() : citations() {};
+
+	~Bibliography()
+	{
+		for(map<string, Citation *>::iterator c = citations.begin(); c != citations.end(); ++c)
+		{
+			delete c->second;
+		};
+	};
+
+	bool load(const string & filename);
+	void addEntry(const string & citeName, const list<string> & citeLines);
+	Citation * getCitation(const string & citeName) const;
+	unsigned int getNoCitations() const {return citations.size();};
+};
+
+#endif
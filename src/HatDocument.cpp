@@ -0,0 +1,429 @@
+/*
+  Richard Howey
+  Research Software Engineering, Newcastle University
+  HAT-DOCS: HTML and TeX documentation from one common source
+*/
+
+#include <sstream>
+#include <fstream>
+#include <algorithm>
+#include <cstdlib>
+#include <cstdio>
+
+using namespace std; // initiates the "std" or "standard" namespace
+
+#include "HatDocument.h"
+
+const string HatDocument::buildVersion = "HATBUILD1";
+
+//the same white space as used by >> in the "C" locale
+bool isWhiteSpace(const char & aChar)
+{
+	return aChar == ' ' || aChar == '\n' || aChar == '\t' || aChar == '\r' || aChar == '\v' || aChar == '\f';
+};
+
+HatFile::HatFile(const string & na, const string & te) : name(na), text(te), hash(getTextHash(te)), wordStarts(), wordEnds()
+{
+	unsigned int length = text.length();
+	unsigned int pos = 0;
+
+	//find the start and end of every word
+	while(pos < length)
+	{
+		while(pos < length && isWhiteSpace(text[pos])) pos++;
+		if(pos == length) break;
+
+		wordStarts.push_back(pos);
+		while(pos < length && !isWhiteSpace(text[pos])) pos++;
+		wordEnds.push_back(pos);
+	};
+};
+
+//returns the index of the first word ending after the given position
+unsigned int HatFile::getWordAfter(const unsigned int & pos) const
+{
+	return upper_bound(wordEnds.begin(), wordEnds.end(), pos) - wordEnds.begin();
+};
+
+void HatStream::close()
+{
+	file = 0;
+};
+
+//continue reading from a position found by an earlier read of the same file, as if all words before it had been read
+void HatStream::moveTo(const unsigned int & newPos)
+{
+	if(file == 0) return;
+
+	pos = newPos;
+	nextWord = file->getWordAfter(pos);
+	eofBit = (pos == file->text.length());
+};
+
+//looks at the next word without reading it, a word will not be found if the next read would fail
+bool HatStream::nextWordStartsWith(const char * start) const
+{
+	if(!good() || file == 0 || nextWord >= file->getNoWords()) return false;
+
+	unsigned int wordPos = file->wordStarts[nextWord];
+	if(wordPos < pos) wordPos = pos;
+	unsigned int end = file->wordEnds[nextWord];
+
+	for(; *start != '\0'; ++start, ++wordPos)
+	{
+		if(wordPos >= end || file->text[wordPos] != *start) return false;
+	};
+
+	return true;
+};
+
+//finds the next word in the same way as >> for an ifstream, returns false and sets the state if there is none
+bool HatStream::readWord(unsigned int & start, unsigned int & end)
+{
+	if(!good() || file == 0 || nextWord >= file->getNoWords())
+	{
+		eofBit = eofBit || file == 0 || (good() && nextWord >= file->getNoWords());
+		failBit = true;
+		return false;
+	};
+
+	//the read position may be part way through a word after using getline
+	start = file->wordStarts[nextWord];
+	if(start < pos) start = pos;
+	end = file->wordEnds[nextWord];
+
+	pos = end;
+	nextWord++;
+	if(pos == file->text.length()) eofBit = true;
+
+	return true;
+};
+
+HatStream & HatStream::operator>>(string & word)
+{
+	unsigned int start, end;
+
+	//assign reuses the memory of the word so usually nothing is allocated
+	if(readWord(start, end)) word.assign(file->text, start, end - start);
+
+	return *this;
+};
+
+HatStream & HatStream::operator>>(HatWord & word)
+{
+	unsigned int start, end;
+
+	if(readWord(start, end))
+	{
+		word.start = file->text.data() + start;
+		word.length = end - start;
+		word.offset = start;
+	};
+
+	return *this;
+};
+
+HatStream & HatStream::operator>>(int & number)
+{
+	if(!good() || file == 0 || nextWord >= file->getNoWords())
+	{
+		eofBit = eofBit || file == 0 || (good() && nextWord >= file->getNoWords());
+		failBit = true;
+		return *this;
+	};
+
+	unsigned int start = file->wordStarts[nextWord];
+	if(start < pos) start = pos;
+	unsigned int end = file->wordEnds[nextWord];
+	unsigned int digitsEnd = start;
+
+	if(digitsEnd < end && (file->text[digitsEnd] == '-' || file->text[digitsEnd] == '+')) digitsEnd++;
+	unsigned int digitsStart = digitsEnd;
+	while(digitsEnd < end && file->text[digitsEnd] >= '0' && file->text[digitsEnd] <= '9') digitsEnd++;
+
+	if(digitsEnd == digitsStart)
+	{
+		number = 0;
+		failBit = true;
+	}
+	else number = atoi(file->text.substr(start, digitsEnd - start).c_str());
+
+	pos = digitsEnd;
+	nextWord = file->getWordAfter(pos);
+	if(pos == file->text.length()) eofBit = true;
+
+	return *this;
+};
+
+void getline(HatStream & fileIn, string & aString, char delim)
+{
+	if(!fileIn.good() || fileIn.file == 0)
+	{
+		fileIn.failBit = true;
+		return;
+	};
+
+	const string & text = fileIn.file->text;
+	size_t delimPos = text.find(delim, fileIn.pos);
+
+	if(delimPos == string::npos)
+	{
+		//nothing left to read is a failure, otherwise read up to the end of the file
+		if(fileIn.pos == text.length()) fileIn.failBit = true;
+		aString.assign(text, fileIn.pos, string::npos);
+		fileIn.pos = text.length();
+		fileIn.eofBit = true;
+	}
+	else
+	{
+		aString.assign(text, fileIn.pos, delimPos - fileIn.pos);
+		fileIn.pos = delimPos + 1;
+	};
+
+	fileIn.nextWord = fileIn.file->getWordAfter(fileIn.pos);
+};
+
+HatFile * HatDocument::getFile(const string & filename)
+{
+	if(sharedFiles != 0) return sharedFiles->getFile(filename);
+
+	lock_guard<mutex> lock(loading);
+
+	map<string, HatFile *>::const_iterator f = files.find(filename);
+	if(f != files.end()) return f->second;
+
+	ifstream fileIn(filename.c_str());
+	if(!fileIn.is_open()) return 0;
+
+	ostringstream fileText;
+	fileText << fileIn.rdbuf();
+	fileIn.close();
+
+	HatFile * hatFile = new HatFile(filename, fileText.str());
+	files[filename] = hatFile;
+
+	return hatFile;
+};
+
+Bibliography * HatDocument::getBibliography(const string & bibFileName)
+{
+	if(sharedFiles != 0) return sharedFiles->getBibliography(bibFileName);
+
+	lock_guard<mutex> lock(loading);
+
+	map<string, Bibliography *>::const_iterator b = bibliographies.find(bibFileName);
+	if(b != bibliographies.end()) return b->second;
+
+	Bibliography * bibliography = new Bibliography();
+	if(!bibliography->load(bibFileName))
+	{
+		delete bibliography;
+		return 0;
+	};
+
+	bibliographies[bibFileName] = bibliography;
+
+	return bibliography;
+};
+
+//reads how the outputs were made in the last build, if there is no build file everything is made again
+void HatDocument::loadBuild(const string & buildFileName)
+{
+	ifstream fileBuildIn(buildFileName.c_str(), ios::binary);
+	if(!fileBuildIn.is_open()) return;
+
+	ostringstream buildText;
+	buildText << fileBuildIn.rdbuf();
+	fileBuildIn.close();
+
+	string build = buildText.str();
+	if(build.compare(0, buildVersion.length(), buildVersion) != 0) return;
+
+	size_t pos = buildVersion.length();
+	unsigned long long noOutputs, noFiles, hash;
+	string output, fileName;
+	if(!readNumber(build, pos, noOutputs)) return;
+
+	for(unsigned long long i = 0; i < noOutputs; ++i)
+	{
+		BuildRecord record;
+		if(!(readString(build, pos, output) && readNumber(build, pos, record.key) && readString(build, pos, record.warnings) && readNumber(build, pos, noFiles)))
+		{
+			previousBuild.clear();
+			return;
+		};
+
+		for(unsigned long long f = 0; f < noFiles; ++f)
+		{
+			if(!readString(build, pos, fileName))
+			{
+				previousBuild.clear();
+				return;
+			};
+			record.filesCreated.push_back(fileName);
+		};
+
+		if(!readNumber(build, pos, noFiles))
+		{
+			previousBuild.clear();
+			return;
+		};
+
+		for(unsigned long long f = 0; f < noFiles; ++f)
+		{
+			if(!(readString(build, pos, fileName) && readNumber(build, pos, hash)))
+			{
+				previousBuild.clear();
+				return;
+			};
+			record.filesRead[fileName] = hash;
+		};
+
+		previousBuild[output] = record;
+	};
+};
+
+//writes how the outputs were made in this build for the next build, it does not matter if this fails
+void HatDocument::saveBuild(const string & buildFileName)
+{
+	lock_guard<mutex> lock(building);
+
+	string build = buildVersion;
+	appendNumber(build, currentBuild.size());
+
+	for(map<string, BuildRecord>::const_iterator b = currentBuild.begin(); b != currentBuild.end(); ++b)
+	{
+		appendString(build, b->first);
+		appendNumber(build, b->second.key);
+		appendString(build, b->second.warnings);
+
+		appendNumber(build, b->second.filesCreated.size());
+		for(list<string>::const_iterator f = b->second.filesCreated.begin(); f != b->second.filesCreated.end(); ++f)
+		{
+			appendString(build, *f);
+		};
+
+		appendNumber(build, b->second.filesRead.size());
+		for(map<string, unsigned long long>::const_iterator f = b->second.filesRead.begin(); f != b->second.filesRead.end(); ++f)
+		{
+			appendString(build, f->first);
+			appendNumber(build, f->second);
+		};
+	};
+
+	//write to a temporary file first so a part written build file is never read
+	string tempFileName = getTempFileName(buildFileName);
+	ofstream fileBuildOut(tempFileName.c_str(), ios::binary);
+	if(!fileBuildOut.is_open()) return;
+
+	fileBuildOut.write(build.data(), build.length());
+	fileBuildOut.close();
+
+	if(fileBuildOut.fail()) remove(tempFileName.c_str());
+	else renameTempFile(tempFileName, buildFileName);
+};
+
+//finds if an output made in the last build is still up to date, if so it is kept for the next build too
+bool HatDocument::getPreviousBuild(const string & output, const unsigned long long & key, BuildRecord & record, HatOutput * hatOutput)
+{
+	{
+		lock_guard<mutex> lock(building);
+
+		map<string, BuildRecord>::const_iterator b = previousBuild.find(output);
+		if(b == previousBuild.end() || b->second.key != key) return false;
+
+		record = b->second;
+	};
+
+	for(map<string, unsigned long long>::const_iterator f = record.filesRead.begin(); f != record.filesRead.end(); ++f)
+	{
+		HatFile * hatFile = getFile(f->first);
+		if(hatFile == 0 || hatFile->hash != f->second) return false;
+	};
+
+	//the files may have been deleted since
+	for(list<string>::const_iterator f = record.filesCreated.begin(); f != record.filesCreated.end(); ++f)
+	{
+		if(!hatOutput->hasFile(*f)) return false;
+	};
+
+	addBuild(output, record);
+
+	return true;
+};
+
+void HatDocument::addBuild(const string & output, const BuildRecord & record)
+{
+	lock_guard<mutex> lock(building);
+
+	currentBuild[output] = record;
+};
+
+//the outputs of this build become those of the last build, for building again without reading the build file
+void HatDocument::endBuild()
+{
+	lock_guard<mutex> lock(building);
+
+	previousBuild.swap(currentBuild);
+	currentBuild.clear();
+};
+
+//the outputs made before a fatal error are added to those of the last build, the others are made again in the next build
+void HatDocument::failBuild()
+{
+	lock_guard<mutex> lock(building);
+
+	for(map<string, BuildRecord>::const_iterator b = currentBuild.begin(); b != currentBuild.end(); ++b)
+	{
+		previousBuild[b->first] = b->second;
+	};
+	currentBuild.clear();
+};
+
+//the names of all the source and bib files read so far
+list<string> HatDocument::getFileNames()
+{
+	if(sharedFiles != 0) return sharedFiles->getFileNames();
+
+	lock_guard<mutex> lock(loading);
+
+	list<string> fileNames;
+
+	for(map<string, HatFile *>::const_iterator f = files.begin(); f != files.end(); ++f)
+	{
+		fileNames.push_back(f->first);
+	};
+
+	for(map<string, Bibliography *>::const_iterator b = bibliographies.begin(); b != bibliographies.end(); ++b)
+	{
+		fileNames.push_back(b->first);
+	};
+
+	return fileNames;
+};
+
+//forgets a file that has changed so that it is read again when next needed
+void HatDocument::removeFile(const string & filename)
+{
+	if(sharedFiles != 0)
+	{
+		sharedFiles->removeFile(filename);
+		return;
+	};
+
+	lock_guard<mutex> lock(loading);
+
+	map<string, HatFile *>::iterator f = files.find(filename);
+	if(f != files.end())
+	{
+		delete f->second;
+		files.erase(f);
+	};
+
+	map<string, Bibliography *>::iterator b = bibliographies.find(filename);
+	if(b != bibliographies.end())
+	{
+		delete b->second;
+		bibliographies.erase(b);
+	};
+};
@@ -0,0 +1,153 @@
+/*
+  Richard Howey
+  Research Software Engineering, Newcastle University
+  HAT-DOCS: HTML and TeX documentation from one common source
+*/
+
+#ifndef __HATDOCUMENT
+#define __HATDOCUMENT
+
+#include <string>
+#include <vector>
+#include <list>
+#include <map>
+#include <cstring>
+#include <mutex>
+
+#include "Bibliography.h"
+#include "HatOutput.h"
+
+//a source file held in memory, the words are found once when it is loaded
+struct HatFile
+{
+	string name;
+	string text;
+	unsigned long long hash; //of the text, to find if a file has changed since the last build
+	vector<unsigned int> wordStarts; //position of first char of each word in text
+	vector<unsigned int> wordEnds; //position one past the last char of each word
+
+	HatFile(const string & na, const string & te);
+
+	~HatFile()
+	{
+
+	};
+
+	unsigned int getNoWords() const {return wordStarts.size();};
+	unsigned int getWordAfter(const unsigned int & pos) const;
+};
+
+//a word of a HatFile read without copying it, along with its position in the file
+struct HatWord
+{
+	const char * start;
+	unsigned int length;
+	unsigned int offset;
+
+	HatWord() : start(0), length(0), offset(0) {};
+
+	template<size_t N> bool operator==(const char (& aString)[N]) const {return length == N - 1 && memcmp(start, aString, N - 1) == 0;};
+	template<size_t N> bool operator!=(const char (& aString)[N]) const {return !(*this == aString);};
+	template<size_t N> bool startsWith(const char (& aString)[N]) const {return length >= N - 1 && memcmp(start, aString, N - 1) == 0;};
+	template<size_t N> bool endsWith(const char (& aString)[N]) const {return length >= N - 1 && memcmp(start + length - (N - 1), aString, N - 1) == 0;};
+	bool startsWith(const string & aString) const {return length >= aString.length() && memcmp(start, aString.data(), aString.length()) == 0;};
+	string str() const {return string(start, length);};
+};
+
+//reads words from a HatFile in the same way as reading from an ifstream with >> and getline
+class HatStream
+{
+private:
+
+	HatFile * file;
+	unsigned int pos; //position of next char to read
+	unsigned int nextWord; //index of the first word ending after pos
+	bool eofBit;
+	bool failBit;
+
+	bool readWord(unsigned int & start, unsigned int & end);
+
+public:
+
+	HatStream(HatFile * hf) : file(hf), pos(0), nextWord(0), eofBit(false), failBit(false) {};
+
+	~HatStream()
+	{
+
+	};
+
+	bool is_open() const {return file != 0;};
+	HatFile * getFile() const {return file;};
+	unsigned int getPosition() const {return pos;};
+	void moveTo(const unsigned int & newPos);
+	bool eof() const {return eofBit;};
+	bool good() const {return !eofBit && !failBit;};
+	void close();
+	bool nextWordStartsWith(const char * start) const;
+
+	HatStream & operator>>(string & word);
+	HatStream & operator>>(HatWord & word);
+	HatStream & operator>>(int & number);
+
+	friend void getline(HatStream & fileIn, string & aString, char delim);
+};
+
+void getline(HatStream & fileIn, string & aString, char delim);
+
+//how an output was made in a build, it need not be made again if it has the same key and none of the files read have changed
+struct BuildRecord
+{
+	unsigned long long key; //hash of everything else the output depends on
+	list<string> filesCreated;
+	string warnings;
+	map<string, unsigned long long> filesRead; //file name, hash of text
+
+	BuildRecord() : key(0), filesCreated(), warnings(""), filesRead() {};
+};
+
+//all of the source files of a document, each file is read from disk and split into words only once
+//and each bib file is read and split into entries only once
+class HatDocument
+{
+private:
+
+	HatDocument * sharedFiles; //files shared with other documents built at the same time, if any
+	map<string, HatFile *> files; //file name, file
+	map<string, Bibliography *> bibliographies; //bib file name, bibliography
+	mutex loading; //files may be asked for by the html and tex processing at the same time
+	map<string, BuildRecord> previousBuild; //output name, how it was made in the last build
+	map<string, BuildRecord> currentBuild;
+	mutex building;
+
+	static const string buildVersion; //start of a build file, changed if the format or output changes
+
+public:
+
+	HatDocument(HatDocument * shared = 0) : sharedFiles(shared), files(), bibliographies(), loading(), previousBuild(), currentBuild(), building() {};
+
+	~HatDocument()
+	{
+		for(map<string, HatFile *>::iterator f = files.begin(); f != files.end(); ++f)
+		{
+			delete f->second;
+		};
+
+		for(map<string, Bibliography *>::iterator b = bibliographies.begin(); b != bibliographies.end(); ++b)
+		{
+			delete b->second;
+		};
+	};
+
+	HatFile * getFile(const string & filename);
+	Bibliography * getBibliography(const string & bibFileName);
+	void loadBuild(const string & buildFileName);
+	void saveBuild(const string & buildFileName);
+	bool getPreviousBuild(const string & output, const unsigned long long & key, BuildRecord & record, HatOutput * hatOutput);
+	void addBuild(const string & output, const BuildRecord & record);
+	void endBuild();
+	void failBuild();
+	list<string> getFileNames();
+	void removeFile(const string & filename);
+};
+
+#endif
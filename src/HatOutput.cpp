@@ -0,0 +1,255 @@
+/*
+  Richard Howey
+  Research Software Engineering, Newcastle University
+  HAT-DOCS: HTML and TeX documentation from one common source
+*/
+
+#include <fstream>
+#include <sstream>
+#include <cstdio>
+#include <cctype>
+#include <sys/stat.h>
+#ifndef HAT_NO_ZLIB
+#include <zlib.h>
+#endif
+
+#ifdef _WIN32
+#include <direct.h>
+#include <process.h>
+#else
+#include <unistd.h>
+#endif
+
+using namespace std; // initiates the "std" or "standard" namespace
+
+#include "HatOutput.h"
+
+#ifdef _WIN32
+const string pathSeparators = "/\\";
+#else
+const string pathSeparators = "/";
+#endif
+
+//a path from the root, or on Windows from a drive such as C:\site or C:/site, is not put in the output directory
+bool isAbsolutePath(const string & fileName)
+{
+	if(fileName != "" && pathSeparators.find(fileName[0]) != string::npos) return true;
+
+#ifdef _WIN32
+	return fileName.length() > 1 && isalpha((unsigned char)fileName[0]) && fileName[1] == ':';
+#else
+	return false;
+#endif
+};
+
+string HatOutput::getPath(const string & fileName) const
+{
+	if(directory == "" || isAbsolutePath(fileName)) return fileName;
+	if(pathSeparators.find(directory[directory.length() - 1]) != string::npos) return directory + fileName;
+
+	return directory + "/" + fileName;
+};
+
+//makes any directories in a path that do not exist yet
+void makeDirectories(const string & path)
+{
+	for(size_t slash = path.find_first_of(pathSeparators, 1); slash != string::npos; slash = path.find_first_of(pathSeparators, slash + 1))
+	{
+#ifdef _WIN32
+		_mkdir(path.substr(0, slash).c_str());
+#else
+		mkdir(path.substr(0, slash).c_str(), 0777);
+#endif
+	};
+};
+
+//a name for writing a file to before it is renamed into place, the process id is in the name
+//in case another build is writing the same file at the same time
+string getTempFileName(const string & fileName)
+{
+	ostringstream tempFileName;
+#ifdef _WIN32
+	tempFileName << fileName << "." << _getpid() << ".tmp";
+#else
+	tempFileName << fileName << "." << getpid() << ".tmp";
+#endif
+
+	return tempFileName.str();
+};
+
+//renames a temporary file into place, on Windows a file cannot be renamed over another so that is removed first,
+//the temporary file is removed if the rename fails
+bool renameTempFile(const string & tempFileName, const string & fileName)
+{
+	if(rename(tempFileName.c_str(), fileName.c_str()) == 0) return true;
+
+	if(remove(fileName.c_str()) == 0 && rename(tempFileName.c_str(), fileName.c_str()) == 0) return true;
+
+	remove(tempFileName.c_str());
+
+	return false;
+};
+
+bool HatOutput::hasFile(const string & fileName)
+{
+	struct stat fileStatus;
+	return stat(getPath(fileName).c_str(), &fileStatus) == 0;
+};
+
+//compares the text with a file already written, the sizes are compared first so most changed files are not read
+bool HatOutput::isUnchanged(const string & fileName, const string & text)
+{
+	string path = getPath(fileName);
+	struct stat fileStatus;
+	if(stat(path.c_str(), &fileStatus) != 0 || (unsigned long long)fileStatus.st_size != text.length()) return false;
+
+	ifstream fileIn(path.c_str(), ios::binary);
+	if(!fileIn.is_open()) return false;
+
+	const size_t bufferSize = 65536;
+	char buffer[bufferSize];
+	size_t pos = 0;
+
+	while(pos < text.length())
+	{
+		fileIn.read(buffer, bufferSize);
+		size_t noRead = fileIn.gcount();
+		if(noRead == 0 || pos + noRead > text.length() || text.compare(pos, noRead, buffer, noRead) != 0) return false;
+		pos += noRead;
+	};
+
+	return true;
+};
+
+//writes the file if it has changed, a file that cannot be written is left as it was before
+HatWriteResult HatOutput::writeFile(const string & fileName, const string & text)
+{
+	if(isUnchanged(fileName, text)) return fileUnchanged;
+
+	string path = getPath(fileName);
+	makeDirectories(path);
+
+	//write the whole file to a temporary file and rename it, so that a part written file is never seen
+	string tempFileName = getTempFileName(path);
+	ofstream fileOut(tempFileName.c_str(), ios::binary);
+	if(!fileOut.is_open()) return fileNotWritten;
+
+	fileOut.write(text.data(), text.length());
+	fileOut.close();
+
+	if(fileOut.fail())
+	{
+		remove(tempFileName.c_str());
+		return fileNotWritten;
+	};
+
+	if(!renameTempFile(tempFileName, path)) return fileNotWritten;
+
+	return fileWritten;
+};
+
+void HatOutput::removeFile(const string & fileName)
+{
+	remove(getPath(fileName).c_str());
+};
+
+//compresses text in the gzip format, the header has no time or name so the same text always gives the same file
+#ifdef HAT_NO_ZLIB
+
+//compiled without zlib, --gzip is not accepted
+bool getGzipText(const string & text, string & compressed, const int & level)
+{
+	return false;
+};
+
+#else
+
+bool getGzipText(const string & text, string & compressed, const int & level)
+{
+	z_stream stream;
+	stream.zalloc = Z_NULL;
+	stream.zfree = Z_NULL;
+	stream.opaque = Z_NULL;
+
+	//15 window bits plus 16 for a gzip header rather than a zlib one
+	if(deflateInit2(&stream, level, Z_DEFLATED, 15 + 16, 8, Z_DEFAULT_STRATEGY) != Z_OK) return false;
+
+	compressed.resize(deflateBound(&stream, text.length()));
+
+	stream.next_in = (Bytef *)text.data();
+	stream.avail_in = text.length();
+	stream.next_out = (Bytef *)&compressed[0];
+	stream.avail_out = compressed.length();
+
+	int result = deflate(&stream, Z_FINISH);
+	compressed.resize(stream.total_out);
+	deflateEnd(&stream);
+
+	return result == Z_STREAM_END;
+};
+
+#endif
+
+bool HatMemoryOutput::hasFile(const string & fileName)
+{
+	lock_guard<mutex> lock(writing);
+
+	return files.find(fileName) != files.end();
+};
+
+bool HatMemoryOutput::isUnchanged(const string & fileName, const string & text)
+{
+	lock_guard<mutex> lock(writing);
+
+	map<string, string>::const_iterator f = files.find(fileName);
+
+	return f != files.end() && f->second == text;
+};
+
+HatWriteResult HatMemoryOutput::writeFile(const string & fileName, const string & text)
+{
+	if(isUnchanged(fileName, text)) return fileUnchanged;
+
+	lock_guard<mutex> lock(writing);
+
+	files[fileName] = text;
+
+	return fileWritten;
+};
+
+void HatMemoryOutput::removeFile(const string & fileName)
+{
+	lock_guard<mutex> lock(writing);
+
+	files.erase(fileName);
+};
+
+//the files of a build without a fatal error are served until the next such build,
+//so pages part written by a failed build are never served
+void HatMemoryOutput::publishFiles(const string & fp)
+{
+	lock_guard<mutex> lock(writing);
+
+	publishedFiles = files;
+	firstPage = fp;
+};
+
+//gets a copy of a file, as the file may be written again while the copy is used
+bool HatMemoryOutput::getFile(const string & fileName, string & text)
+{
+	lock_guard<mutex> lock(writing);
+
+	map<string, string>::const_iterator f = publishedFiles.find(fileName);
+	if(f == publishedFiles.end()) return false;
+
+	text = f->second;
+
+	return true;
+};
+
+string HatMemoryOutput::getFirstPage()
+{
+	lock_guard<mutex> lock(writing);
+
+	return firstPage;
+};
@@ -0,0 +1,77 @@
+/*
+  Richard Howey
+  Research Software Engineering, Newcastle University
+  HAT-DOCS: HTML and TeX documentation from one common source
+*/
+
+#ifndef __HATOUTPUT
+#define __HATOUTPUT
+
+#include <string>
+#include <map>
+#include <mutex>
+
+enum HatWriteResult {fileUnchanged, fileWritten, fileNotWritten};
+
+//where the output files are written, a file is only written if it is different to the file already there
+//so that files which have not changed keep their times
+class HatOutput
+{
+private:
+
+	string directory; //where the files go, the current directory if empty
+
+public:
+
+	HatOutput(const string & dir = "") : directory(dir) {};
+
+	virtual ~HatOutput()
+	{
+
+	};
+
+	string getPath(const string & fileName) const;
+	virtual bool hasFile(const string & fileName);
+	virtual bool isUnchanged(const string & fileName, const string & text);
+	virtual HatWriteResult writeFile(const string & fileName, const string & text);
+	virtual void removeFile(const string & fileName);
+	virtual void publishFiles(const string & firstPage) {};
+};
+
+extern const string pathSeparators; //between the directories of a path, / and also \ on Windows
+
+bool isAbsolutePath(const string & fileName);
+string getTempFileName(const string & fileName);
+bool renameTempFile(const string & tempFileName, const string & fileName);
+bool getGzipText(const string & text, string & compressed, const int & level);
+
+//output files kept in memory rather than written, for serving pages while previewing,
+//the pages served are those of the last build without a fatal error
+class HatMemoryOutput : public HatOutput
+{
+private:
+
+	map<string, string> files; //file name, text
+	map<string, string> publishedFiles; //file name, text
+	string firstPage; //served for the top of the site
+	mutex writing; //pages may be written by the build while they are being served
+
+public:
+
+	HatMemoryOutput() : files(), publishedFiles(), firstPage(""), writing() {};
+
+	~HatMemoryOutput()
+	{
+
+	};
+
+	bool hasFile(const string & fileName);
+	bool isUnchanged(const string & fileName, const string & text);
+	HatWriteResult writeFile(const string & fileName, const string & text);
+	void removeFile(const string & fileName);
+	void publishFiles(const string & firstPage);
+	bool getFile(const string & fileName, string & text);
+	string getFirstPage();
+};
+
+#endif
@@ -0,0 +1,212 @@
+/*
+  Richard Howey
+  Research Software Engineering, Newcastle University
+  HAT-DOCS: HTML and TeX documentation from one common source
+*/
+
+#include <cstdio>
+#include <cctype>
+#include <set>
+
+using namespace std; // initiates the "std" or "standard" namespace
+
+#include "HatPageStream.h"
+
+int HatMinifyBuffer::overflow(int aChar)
+{
+	if(aChar == EOF) return 0;
+
+	if(minify) addChar((char)aChar);
+	else text += (char)aChar;
+
+	return aChar;
+};
+
+streamsize HatMinifyBuffer::xsputn(const char * chars, streamsize noChars)
+{
+	if(!minify)
+	{
+		text.append(chars, noChars);
+		return noChars;
+	};
+
+	//runs of chars in text or in a tag that are written as they are, which is most of them, are added in one go
+	streamsize i = 0;
+	while(i < noChars)
+	{
+		streamsize end = i;
+
+		if(state == textState)
+		{
+			while(end < noChars && chars[end] != '<' && chars[end] != ' ' && chars[end] != '\n' && chars[end] != '\t' && chars[end] != '\r') end++;
+
+			if(end > i)
+			{
+				if(space != 0) text += space;
+				space = 0;
+				afterBlockTag = false;
+			};
+		}
+		else if(state == tagState && !readingTagName)
+		{
+			if(quote != 0) while(end < noChars && chars[end] != quote) end++;
+			else while(end < noChars && chars[end] != '>' && chars[end] != '"' && chars[end] != '\'') end++;
+		};
+
+		if(end > i)
+		{
+			text.append(chars + i, end - i);
+			i = end;
+		}
+		else
+		{
+			addChar(chars[i]);
+			i++;
+		};
+	};
+
+	return noChars;
+};
+
+//elements which start on a new line, so white space next to their tags does not show, list items are not included
+//as they are sometimes shown in a line, such as the menu
+bool isBlockTag(const string & tagName)
+{
+	static const set<string> blockTags = {"html", "head", "title", "meta", "link", "body", "div", "table", "thead", "tbody", "tfoot", "tr", "td", "th",
+		"ul", "ol", "dl", "dt", "dd", "p", "h1", "h2", "h3", "h4", "h5", "h6", "br", "hr", "form", "pre", "blockquote", "script", "style", "noscript"};
+
+	return tagName.length() <= 10 && blockTags.find(tagName) != blockTags.end();
+};
+
+//adds the next char of the html, only white space in text and comments are left out so the page looks the same
+void HatMinifyBuffer::addChar(const char & aChar)
+{
+	switch(state)
+	{
+		case textState:
+			if(aChar == ' ' || aChar == '\n' || aChar == '\t' || aChar == '\r')
+			{
+				//a new line is kept rather than a space as it is the same size, white space at the start is not needed
+				if(text != "" && !afterBlockTag) space = (space == '\n' || aChar == '\n' || aChar == '\r') ? '\n' : ' ';
+			}
+			else if(aChar == '<')
+			{
+				tagStart = "<";
+				state = tagStartState;
+			}
+			else
+			{
+				if(space != 0) text += space;
+				space = 0;
+				afterBlockTag = false;
+				text += aChar;
+			};
+			break;
+
+		case tagStartState:
+			//wait for enough chars to find if it is a comment
+			tagStart += aChar;
+			if(tagStart == "<!--")
+			{
+				noDashes = 0;
+				state = commentState;
+			}
+			else if(tagStart.compare(0, tagStart.length(), "<!--", tagStart.length()) != 0)
+			{
+				//any white space before the tag is added once the tag name is known
+				tagPos = text.length();
+				text += '<';
+				tagName = "";
+				readingTagName = true;
+				closingTag = false;
+				quote = 0;
+				state = tagState;
+
+				for(string::const_iterator c = tagStart.begin() + 1; c != tagStart.end(); ++c)
+				{
+					addTagChar(*c);
+				};
+			};
+			break;
+
+		case tagState:
+			addTagChar(aChar);
+			break;
+
+		case commentState:
+			if(aChar == '>' && noDashes >= 2) state = textState;
+			noDashes = (aChar == '-') ? noDashes + 1 : 0;
+			break;
+
+		case rawState:
+			text += aChar;
+			if(aChar == rawEnd[rawEnd.length() - 1] && text.length() >= rawEnd.length())
+			{
+				bool atEnd = true;
+				for(size_t i = 0, pos = text.length() - rawEnd.length(); i < rawEnd.length() && atEnd; ++i, ++pos)
+				{
+					atEnd = (tolower((unsigned char)text[pos]) == rawEnd[i]);
+				};
+
+				if(atEnd)
+				{
+					tagName = rawEnd.substr(2);
+					readingTagName = false;
+					closingTag = true;
+					quote = 0;
+					state = tagState;
+				};
+			};
+			break;
+	};
+};
+
+//the white space before a tag is only needed if it is not the tag of a block element
+void HatMinifyBuffer::endTagName()
+{
+	readingTagName = false;
+
+	if(space != 0 && !isBlockTag(tagName)) text.insert(tagPos, 1, space);
+	space = 0;
+};
+
+//adds a char of a tag as it is, the tag name is noted to find elements where white space matters
+void HatMinifyBuffer::addTagChar(const char & aChar)
+{
+	text += aChar;
+
+	if(quote != 0)
+	{
+		if(aChar == quote) quote = 0;
+		return;
+	};
+
+	if(readingTagName)
+	{
+		if((aChar >= 'a' && aChar <= 'z') || (aChar >= 'A' && aChar <= 'Z') || (aChar >= '0' && aChar <= '9'))
+		{
+			tagName += tolower(aChar);
+			return;
+		}
+		else if(aChar == '/' && tagName == "" && !closingTag)
+		{
+			closingTag = true;
+			return;
+		};
+
+		endTagName();
+	};
+
+	if(aChar == '"' || aChar == '\'') quote = aChar;
+	else if(aChar == '>')
+	{
+		afterBlockTag = isBlockTag(tagName);
+
+		if(!closingTag && (tagName == "pre" || tagName == "script" || tagName == "style" || tagName == "textarea"))
+		{
+			rawEnd = "</" + tagName;
+			state = rawState;
+		}
+		else state = textState;
+	};
+};
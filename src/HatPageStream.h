@@ -0,0 +1,77 @@
+/*
+  Richard Howey
+  Research Software Engineering, Newcastle University
+  HAT-DOCS: HTML and TeX documentation from one common source
+*/
+
+#ifndef __HATPAGESTREAM
+#define __HATPAGESTREAM
+
+#include <string>
+#include <ostream>
+#include <streambuf>
+
+//keeps the html written to it, if minifying then comments are left out and each run of white space is written as one char
+//as the html is written, or left out next to the tags of block elements, except in pre, script, style and textarea elements
+//where white space matters
+class HatMinifyBuffer : public streambuf
+{
+private:
+
+	enum MinifyState {textState, tagStartState, tagState, commentState, rawState};
+
+	string text;
+	bool minify;
+	MinifyState state;
+	char space; //white space to write before the next char that is not white space, 0 for none
+	string tagStart; //the start of a tag, which may be the start of a comment
+	string tagName; //of the tag being read, lower case
+	bool readingTagName;
+	bool closingTag;
+	size_t tagPos; //where the tag being read starts in the text
+	bool afterBlockTag; //white space is not needed next to tags of block elements
+	char quote; //of an attribute value in a tag, 0 if not in one
+	string rawEnd; //end tag of a pre element etc.
+	unsigned int noDashes; //dashes in a row in a comment
+
+	void addChar(const char & aChar);
+	void addTagChar(const char & aChar);
+	void endTagName();
+
+protected:
+
+	int overflow(int aChar);
+	streamsize xsputn(const char * chars, streamsize noChars);
+
+public:
+
+	HatMinifyBuffer(const bool & mi) : text(""), minify(mi), state(textState), space(0), tagStart(""), tagName(""), readingTagName(false), closingTag(false), tagPos(0), afterBlockTag(false), quote(0), rawEnd(""), noDashes(0) {};
+
+	~HatMinifyBuffer()
+	{
+
+	};
+
+	const string & str() const {return text;};
+};
+
+//a stream for writing an html page, minified or not
+class HatPageStream : public ostream
+{
+private:
+
+	HatMinifyBuffer buffer;
+
+public:
+
+	HatPageStream(const bool & minify) : ostream(0), buffer(minify) {rdbuf(&buffer);};
+
+	~HatPageStream()
+	{
+
+	};
+
+	const string & str() const {return buffer.str();};
+};
+
+#endif
@@ -0,0 +1,243 @@
+/*
+  Richard Howey
+  Research Software Engineering, Newcastle University
+  HAT-DOCS: HTML and TeX documentation from one common source
+*/
+
+#include <sstream>
+
+using namespace std; // initiates the "std" or "standard" namespace
+
+#include "HatSearch.h"
+
+//the terms are split into files by their first char, any other first char is in the "_" file
+const char * searchShards = "0123456789abcdefghijklmnopqrstuvwxyz_";
+
+//letters and digits, any other chars of a character set above ascii are kept as part of a term too
+bool isTermChar(const char & aChar)
+{
+	return (aChar >= 'a' && aChar <= 'z') || (aChar >= 'A' && aChar <= 'Z') || (aChar >= '0' && aChar <= '9') || (unsigned char)aChar >= 128;
+};
+
+//lower case as toLowerCase in the search script does for iso-8859-1, so that terms with accented capitals match
+//what is typed, \xC0 to \xDE are the capitals apart from the multiplication sign \xD7
+char getLowerCaseChar(const char & aChar)
+{
+	unsigned char uChar = (unsigned char)aChar;
+
+	if((uChar >= 'A' && uChar <= 'Z') || (uChar >= 0xC0 && uChar <= 0xDE && uChar != 0xD7)) return (char)(uChar + 0x20);
+
+	return aChar;
+};
+
+char getSearchShard(const string & term)
+{
+	char first = term[0];
+	if((first >= 'a' && first <= 'z') || (first >= '0' && first <= '9')) return first;
+
+	return '_';
+};
+
+//adds a string in double quotes for javascript
+void appendScriptString(string & script, const string & aString)
+{
+	script += '"';
+
+	for(string::const_iterator c = aString.begin(); c != aString.end(); ++c)
+	{
+		if(*c == '"' || *c == '\\') script += '\\';
+
+		if(*c == '\n' || *c == '\r' || *c == '\t') script += ' ';
+		else if(*c == '/' && c != aString.begin() && *(c - 1) == '<') script += "\\/"; //so "</script>" does not end a script
+		else script += *c;
+	};
+
+	script += '"';
+};
+
+//the page or section that the following text is on, text is added to the same target if it is set again
+void HatSearch::setTarget(const string & link, const string & title)
+{
+	map<string, unsigned int>::const_iterator t = targetNumbers.find(link);
+	if(t != targetNumbers.end())
+	{
+		currentTarget = t->second;
+		return;
+	};
+
+	currentTarget = targets.size();
+	targetNumbers[link] = currentTarget;
+	targets.push_back(SearchTarget(link, title));
+};
+
+//splits text into lower case terms and adds each one, markup such as the "b" of "*b*bold*/b*" is not added
+void HatSearch::addText(const char * text, const unsigned int & length)
+{
+	if(currentTarget < 0) return;
+
+	SearchTarget & target = targets[currentTarget];
+	string term;
+	unsigned int pos = 0;
+	unsigned int start;
+
+	while(pos < length)
+	{
+		while(pos < length && !isTermChar(text[pos])) pos++;
+		if(pos == length) break;
+
+		start = pos;
+		while(pos < length && isTermChar(text[pos])) pos++;
+
+		if(pos < length && text[pos] == '*' && start > 0 && (text[start - 1] == '*' || (text[start - 1] == '/' && start > 1 && text[start - 2] == '*'))) continue;
+
+		term.assign(text + start, pos - start);
+		for(string::iterator c = term.begin(); c != term.end(); ++c)
+		{
+			*c = getLowerCaseChar(*c);
+		};
+
+		terms[term][currentTarget].push_back(target.noTerms);
+		target.noTerms++;
+	};
+};
+
+//the search script, the targets and a file of terms for each first char, all of the term files are given
+//even if empty so that a file left from an earlier build is never used
+void HatSearch::getFiles(map<string, string> & files) const
+{
+	files["search/search.js"] = searchScript;
+
+	string script = "hatSearch.addTargets([\n";
+	for(vector<SearchTarget>::const_iterator t = targets.begin(); t != targets.end(); ++t)
+	{
+		if(t != targets.begin()) script += ",\n";
+		script += "[";
+		appendScriptString(script, t->link);
+		script += ",";
+		appendScriptString(script, t->title);
+		script += "]";
+	};
+	script += "\n]);\n";
+
+	files["search/targets.js"] = script;
+
+	//the positions are given as the difference from the position before, to keep the files small
+	map<char, string> shards;
+	ostringstream postings;
+	for(map<string, map<unsigned int, vector<unsigned int> > >::const_iterator t = terms.begin(); t != terms.end(); ++t)
+	{
+		string & shard = shards[getSearchShard(t->first)];
+		if(shard != "") shard += ",\n";
+		appendScriptString(shard, t->first);
+
+		postings.str("");
+		postings << ":[";
+		for(map<unsigned int, vector<unsigned int> >::const_iterator p = t->second.begin(); p != t->second.end(); ++p)
+		{
+			if(p != t->second.begin()) postings << ",";
+			postings << "[" << p->first;
+
+			unsigned int lastPosition = 0;
+			for(vector<unsigned int>::const_iterator pos = p->second.begin(); pos != p->second.end(); ++pos)
+			{
+				postings << "," << (*pos - lastPosition);
+				lastPosition = *pos;
+			};
+
+			postings << "]";
+		};
+		postings << "]";
+
+		shard += postings.str();
+	};
+
+	for(const char * s = searchShards; *s != '\0'; ++s)
+	{
+		string shardName(1, *s);
+		script = "hatSearch.addTerms(\"" + shardName + "\",{\n" + shards[*s] + "\n});\n";
+		files["search/terms-" + shardName + ".js"] = script;
+	};
+};
+
+//loads the files of terms needed for a query, ranks the pages by how often the terms are on them and if the
+//terms are next to each other, the last term of a query also matches longer terms starting with it
+const char * HatSearch::searchScript =
+	"var hatSearch = {\n"
+	"targets: null,\n"
+	"shards: {},\n"
+	"loading: {},\n"
+	"maxResults: 50,\n"
+	"addTargets: function(targets) {this.targets = targets; this.search();},\n"
+	"addTerms: function(shard, terms) {this.shards[shard] = terms; this.search();},\n"
+	"getTerms: function(text) {\n"
+	"\treturn text.toLowerCase().split(/[^a-z0-9\\u0080-\\uffff]+/).filter(function(term) {return term.length > 0;});\n"
+	"},\n"
+	"getShard: function(term) {\n"
+	"\tvar first = term.charAt(0);\n"
+	"\treturn /[a-z0-9]/.test(first) ? first : \"_\";\n"
+	"},\n"
+	"load: function(fileName) {\n"
+	"\tif(this.loading[fileName]) return;\n"
+	"\tthis.loading[fileName] = true;\n"
+	"\tvar script = document.createElement(\"script\");\n"
+	"\tscript.type = \"text/javascript\";\n"
+	"\tscript.src = \"search/\" + fileName + \".js\";\n"
+	"\tdocument.body.appendChild(script);\n"
+	"},\n"
+	"getPostings: function(term, startsWith) {\n"
+	"\tvar terms = this.shards[this.getShard(term)];\n"
+	"\tvar postings = {};\n"
+	"\tfor(var t in terms) {\n"
+	"\t\tif(t != term && !(startsWith && t.lastIndexOf(term, 0) == 0)) continue;\n"
+	"\t\tterms[t].forEach(function(p) {\n"
+	"\t\t\tvar positions = postings[p[0]] || (postings[p[0]] = []);\n"
+	"\t\t\tfor(var i = 1, pos = 0; i < p.length; ++i) {pos += p[i]; positions.push(pos);}\n"
+	"\t\t});\n"
+	"\t}\n"
+	"\treturn postings;\n"
+	"},\n"
+	"search: function() {\n"
+	"\tvar results = document.getElementById(\"searchresults\");\n"
+	"\tvar terms = this.getTerms(document.getElementById(\"searchtext\").value);\n"
+	"\tif(terms.length == 0) {results.innerHTML = \"\"; return;}\n"
+	"\tif(this.targets == null) {this.load(\"targets\"); return;}\n"
+	"\tvar loaded = true;\n"
+	"\tfor(var i = 0; i < terms.length; ++i) {\n"
+	"\t\tvar shard = this.getShard(terms[i]);\n"
+	"\t\tif(!(shard in this.shards)) {this.load(\"terms-\" + shard); loaded = false;}\n"
+	"\t}\n"
+	"\tif(!loaded) return;\n"
+	"\tvar matches = null;\n"
+	"\tfor(var i = 0; i < terms.length; ++i) {\n"
+	"\t\tvar postings = this.getPostings(terms[i], i == terms.length - 1);\n"
+	"\t\tif(matches == null) {\n"
+	"\t\t\tmatches = {};\n"
+	"\t\t\tfor(var t in postings) matches[t] = {score: postings[t].length, positions: postings[t]};\n"
+	"\t\t\tcontinue;\n"
+	"\t\t}\n"
+	"\t\tfor(var t in matches) {\n"
+	"\t\t\tif(!(t in postings)) {delete matches[t]; continue;}\n"
+	"\t\t\tvar before = {};\n"
+	"\t\t\tmatches[t].positions.forEach(function(pos) {before[pos + 1] = true;});\n"
+	"\t\t\tvar noNext = postings[t].filter(function(pos) {return before[pos];}).length;\n"
+	"\t\t\tmatches[t].score += postings[t].length + 10 * noNext;\n"
+	"\t\t\tmatches[t].positions = postings[t];\n"
+	"\t\t}\n"
+	"\t}\n"
+	"\tvar found = Object.keys(matches).sort(function(a, b) {return matches[b].score - matches[a].score || a - b;});\n"
+	"\tresults.innerHTML = \"\";\n"
+	"\tvar summary = document.createElement(\"p\");\n"
+	"\tsummary.textContent = found.length == 0 ? \"No pages found.\" : found.length == 1 ? \"1 page found.\" : found.length + \" pages found.\";\n"
+	"\tresults.appendChild(summary);\n"
+	"\tvar list = document.createElement(\"ol\");\n"
+	"\tfor(var i = 0; i < found.length && i < this.maxResults; ++i) {\n"
+	"\t\tvar item = document.createElement(\"li\");\n"
+	"\t\tvar link = document.createElement(\"a\");\n"
+	"\t\tlink.href = this.targets[found[i]][0];\n"
+	"\t\tlink.innerHTML = this.targets[found[i]][1];\n"
+	"\t\titem.appendChild(link);\n"
+	"\t\tlist.appendChild(item);\n"
+	"\t}\n"
+	"\tresults.appendChild(list);\n"
+	"}\n"
+	"};\n";
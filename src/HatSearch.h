@@ -0,0 +1,59 @@
+/*
+  Richard Howey
+  Research Software Engineering, Newcastle University
+  HAT-DOCS: HTML and TeX documentation from one common source
+*/
+
+#ifndef __HATSEARCH
+#define __HATSEARCH
+
+#include <string>
+#include <vector>
+#include <map>
+
+//a page, or a section of a page, that search results link to
+struct SearchTarget
+{
+	string link;
+	string title;
+	unsigned int noTerms; //terms added so far, the position of the next term
+
+	SearchTarget(const string & li, const string & ti) : link(li), title(ti), noTerms(0) {};
+
+	~SearchTarget()
+	{
+
+	};
+};
+
+//an index of every term of a document and where it is, written as javascript files that the search page
+//loads as they are needed, as scripts can be loaded from pages opened from disk where other files cannot
+class HatSearch
+{
+private:
+
+	vector<SearchTarget> targets;
+	map<string, unsigned int> targetNumbers; //link, index of target
+	int currentTarget; //-1 before the first target
+	map<string, map<unsigned int, vector<unsigned int> > > terms; //term, target, positions of the term in the target
+
+	static const char * searchScript;
+
+public:
+
+	HatSearch() : targets(), targetNumbers(), currentTarget(-1), terms() {};
+
+	~HatSearch()
+	{
+
+	};
+
+	void setTarget(const string & link, const string & title);
+	void clearTarget() {currentTarget = -1;};
+	void addText(const char * text, const unsigned int & length);
+	void getFiles(map<string, string> & files) const;
+};
+
+void appendScriptString(string & script, const string & aString);
+
+#endif
@@ -0,0 +1,211 @@
+/*
+  Richard Howey
+  Research Software Engineering, Newcastle University
+  HAT-DOCS: HTML and TeX documentation from one common source
+*/
+
+#include <iostream>
+#include <sstream>
+#include <fstream>
+#include <cstring>
+#include <cstdlib>
+#include <cctype>
+#ifndef _WIN32
+#include <unistd.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#endif
+
+using namespace std; // initiates the "std" or "standard" namespace
+
+#include "HatServer.h"
+
+#ifdef _WIN32
+
+//sockets are not used on Windows, --serve is not accepted there
+bool HatServer::serve()
+{
+	return false;
+};
+
+void HatServer::respond(int connection)
+{
+
+};
+
+#else
+
+#ifndef MSG_NOSIGNAL
+#define MSG_NOSIGNAL 0
+#endif
+
+//accepts connections one at a time until the program is stopped, returns false if the port cannot be used
+bool HatServer::serve()
+{
+	int listener = socket(AF_INET, SOCK_STREAM, 0);
+	if(listener < 0) return false;
+
+	int reuse = 1;
+	setsockopt(listener, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+
+	struct sockaddr_in address;
+	memset(&address, 0, sizeof(address));
+	address.sin_family = AF_INET;
+	address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+	address.sin_port = htons(port);
+
+	if(bind(listener, (struct sockaddr *)&address, sizeof(address)) != 0 || listen(listener, 16) != 0)
+	{
+		close(listener);
+		return false;
+	};
+
+	cout << "\nServing pages at http://localhost:" << port << "/ (Ctrl-C to stop)\n";
+
+	while(true)
+	{
+		int connection = accept(listener, 0, 0);
+		if(connection < 0) continue;
+
+		respond(connection);
+		close(connection);
+	};
+
+	close(listener);
+	return true;
+};
+
+//the path asked for is shown on the not found page, so it must not be taken as html
+string HatServer::getEscapedText(const string & text)
+{
+	string escaped = "";
+
+	for(string::const_iterator c = text.begin(); c != text.end(); ++c)
+	{
+		if(*c == '<') escaped += "&lt;";
+		else if(*c == '>') escaped += "&gt;";
+		else if(*c == '&') escaped += "&amp;";
+		else if(*c == '"') escaped += "&quot;";
+		else escaped += *c;
+	};
+
+	return escaped;
+};
+
+//a path in a request may have characters as %xx, these are decoded before the path is checked
+string HatServer::getDecodedPath(const string & path)
+{
+	string decoded = "";
+
+	for(size_t i = 0; i < path.length(); ++i)
+	{
+		if(path[i] == '%' && i + 2 < path.length() && isxdigit((unsigned char)path[i + 1]) && isxdigit((unsigned char)path[i + 2]))
+		{
+			decoded += (char)strtol(path.substr(i + 1, 2).c_str(), 0, 16);
+			i += 2;
+		}
+		else decoded += path[i];
+	};
+
+	return decoded;
+};
+
+string HatServer::getContentType(const string & fileName)
+{
+	size_t dot = fileName.find_last_of('.');
+	string extension = "";
+	if(dot != string::npos) extension = fileName.substr(dot + 1);
+
+	if(extension == "html") return "text/html; charset=iso-8859-1";
+	else if(extension == "css") return "text/css";
+	else if(extension == "js") return "application/javascript";
+	else if(extension == "json") return "application/json";
+	else if(extension == "png") return "image/png";
+	else if(extension == "jpg" || extension == "jpeg") return "image/jpeg";
+	else if(extension == "gif") return "image/gif";
+	else if(extension == "svg") return "image/svg+xml";
+	else if(extension == "ico") return "image/x-icon";
+	else if(extension == "pdf") return "application/pdf";
+
+	return "text/plain";
+};
+
+//reads a GET request and sends the file asked for
+void HatServer::respond(int connection)
+{
+	string request = "";
+	char buffer[4096];
+
+	while(request.find("\r\n\r\n") == string::npos && request.length() < 65536)
+	{
+		ssize_t noRead = recv(connection, buffer, sizeof(buffer), 0);
+		if(noRead <= 0) break;
+		request.append(buffer, noRead);
+	};
+
+	string method, path;
+	istringstream requestLine(request);
+	requestLine >> method >> path;
+
+	size_t query = path.find_first_of("?#");
+	if(query != string::npos) path = path.substr(0, query);
+	path = getDecodedPath(path);
+
+	//there is no index page, so the top of the site, or any directory, goes to the first page of the document
+	string firstPage = output->getFirstPage();
+	if((path == "" || path[path.length() - 1] == '/') && firstPage != "")
+	{
+		ostringstream redirect;
+		redirect << "HTTP/1.0 302 Found\r\nLocation: /" << firstPage << "\r\nContent-Length: 0\r\nCache-Control: no-cache\r\nConnection: close\r\n\r\n";
+		sendText(connection, redirect.str());
+		return;
+	};
+
+	string fileName = path.length() > 0 ? path.substr(1) : "";
+	string text;
+	bool found = false;
+
+	//only files in the current directory or below may be served
+	if((method == "GET" || method == "HEAD") && path[0] == '/' && fileName[0] != '/' && fileName.find("..") == string::npos && fileName.find('\0') == string::npos)
+	{
+		found = output->getFile(fileName, text);
+
+		if(!found && fileName != "")
+		{
+			ifstream fileIn(fileName.c_str(), ios::binary);
+			if(fileIn.is_open())
+			{
+				ostringstream fileText;
+				fileText << fileIn.rdbuf();
+				text = fileText.str();
+				found = true;
+			};
+		};
+	};
+
+	ostringstream response;
+	if(found) response << "HTTP/1.0 200 OK\r\nContent-Type: " << getContentType(fileName) << "\r\n";
+	else
+	{
+		text = "<html><body><p>Not found: " + getEscapedText(fileName) + "</p></body></html>\n";
+		response << "HTTP/1.0 404 Not Found\r\nContent-Type: text/html\r\n";
+	};
+	response << "Content-Length: " << text.length() << "\r\nCache-Control: no-cache\r\nConnection: close\r\n\r\n";
+	if(method != "HEAD") response << text;
+
+	sendText(connection, response.str());
+};
+
+void HatServer::sendText(int connection, const string & text)
+{
+	size_t pos = 0;
+	while(pos < text.length())
+	{
+		ssize_t noSent = send(connection, text.data() + pos, text.length() - pos, MSG_NOSIGNAL);
+		if(noSent <= 0) break;
+		pos += noSent;
+	};
+};
+
+#endif
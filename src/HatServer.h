@@ -0,0 +1,41 @@
+/*
+  Richard Howey
+  Research Software Engineering, Newcastle University
+  HAT-DOCS: HTML and TeX documentation from one common source
+*/
+
+#ifndef __HATSERVER
+#define __HATSERVER
+
+#include <string>
+
+#include "HatOutput.h"
+
+//a small http server on localhost for previewing, the pages are served from memory
+//and any other files, such as images and style files, are served from the current directory
+class HatServer
+{
+private:
+
+	HatMemoryOutput * output;
+	unsigned int port;
+
+	void respond(int connection);
+	void sendText(int connection, const string & text);
+	string getContentType(const string & fileName);
+	string getEscapedText(const string & text);
+	string getDecodedPath(const string & path);
+
+public:
+
+	HatServer(HatMemoryOutput * out, const unsigned int & po) : output(out), port(po) {};
+
+	~HatServer()
+	{
+
+	};
+
+	bool serve();
+};
+
+#endif
@@ -0,0 +1,111 @@
+/*
+  Richard Howey
+  Research Software Engineering, Newcastle University
+  HAT-DOCS: HTML and TeX documentation from one common source
+*/
+
+#include <fstream>
+#include <iomanip>
+
+using namespace std; // initiates the "std" or "standard" namespace
+
+#include "HatStats.h"
+
+const char * HatStats::phaseNames[noPhases] = {"Title scan", "Section scan", "Webpage scan", "Reference scan", "Bibliography lookups", "HTML render", "TeX render", "Search index", "Gzip compression", "File writes"};
+const char * HatStats::phaseKeys[noPhases] = {"title_scan", "section_scan", "webpage_scan", "reference_scan", "bibliography_lookups", "html_render", "tex_render", "search_index", "gzip", "file_writes"};
+const char * HatStats::countNames[noCounts] = {"Source tokens", "HTML pages", "Figures", "Citations", "Bibliography lookups", "Output bytes", "Files written", "Files unchanged"};
+const char * HatStats::countKeys[noCounts] = {"tokens", "pages", "figures", "citations", "bibliography_lookups", "output_bytes", "files_written", "files_unchanged"};
+
+HatStats::HatStats() : totalSeconds(0), adding()
+{
+	for(unsigned int p = 0; p < noPhases; ++p)
+	{
+		phaseSeconds[p] = 0;
+		phaseBytes[p] = 0;
+		phaseCalls[p] = 0;
+	};
+
+	for(unsigned int c = 0; c < noCounts; ++c) counts[c] = 0;
+};
+
+void HatStats::addPhase(const HatPhase & phase, const double & seconds, const unsigned long long & bytes)
+{
+	lock_guard<mutex> lock(adding);
+
+	phaseSeconds[phase] += seconds;
+	phaseBytes[phase] += bytes;
+	phaseCalls[phase]++;
+};
+
+void HatStats::addCount(const HatCount & count, const unsigned long long & number)
+{
+	lock_guard<mutex> lock(adding);
+
+	counts[count] += number;
+};
+
+void HatStats::display(ostream & out)
+{
+	lock_guard<mutex> lock(adding);
+
+	out << "\nStatistics (phase times are added up over threads, the render times include file writes):\n";
+	out << "  " << left << setw(24) << "Phase" << right << setw(12) << "Seconds" << setw(14) << "Bytes" << setw(10) << "Times" << "\n";
+
+	for(unsigned int p = 0; p < noPhases; ++p)
+	{
+		out << "  " << left << setw(24) << phaseNames[p] << right << setw(12) << fixed << setprecision(4) << phaseSeconds[p]
+			<< setw(14) << phaseBytes[p] << setw(10) << phaseCalls[p] << "\n";
+	};
+
+	out << "  " << left << setw(24) << "Total (wall)" << right << setw(12) << fixed << setprecision(4) << totalSeconds << "\n\n";
+
+	for(unsigned int c = 0; c < noCounts; ++c)
+	{
+		out << "  " << left << setw(24) << countNames[c] << right << setw(12) << counts[c] << "\n";
+	};
+
+	out.unsetf(ios::floatfield);
+	out << setprecision(6);
+};
+
+//writes the statistics as json for build dashboards, returns false if the file cannot be written
+bool HatStats::writeJson(const string & fileName, const string & documentName)
+{
+	lock_guard<mutex> lock(adding);
+
+	ofstream jsonOut(fileName.c_str());
+	if(!jsonOut.is_open()) return false;
+
+	//the document name is only escaped for quotes and backslashes as it is a file name
+	string escapedName = "";
+	for(string::const_iterator c = documentName.begin(); c != documentName.end(); ++c)
+	{
+		if(*c == '"' || *c == '\\') escapedName += '\\';
+		escapedName += *c;
+	};
+
+	jsonOut << "{\n  \"document\": \"" << escapedName << "\",\n"
+			<< "  \"total_seconds\": " << fixed << setprecision(6) << totalSeconds << ",\n"
+			<< "  \"phases\": {\n";
+
+	for(unsigned int p = 0; p < noPhases; ++p)
+	{
+		jsonOut << "    \"" << phaseKeys[p] << "\": {\"seconds\": " << phaseSeconds[p] << ", \"bytes\": " << phaseBytes[p] << ", \"times\": " << phaseCalls[p] << "}";
+		if(p + 1 < noPhases) jsonOut << ",";
+		jsonOut << "\n";
+	};
+
+	jsonOut << "  },\n  \"counts\": {\n";
+
+	for(unsigned int c = 0; c < noCounts; ++c)
+	{
+		jsonOut << "    \"" << countKeys[c] << "\": " << counts[c];
+		if(c + 1 < noCounts) jsonOut << ",";
+		jsonOut << "\n";
+	};
+
+	jsonOut << "  }\n}\n";
+	jsonOut.close();
+
+	return !jsonOut.fail();
+};
@@ -0,0 +1,76 @@
+/*
+  Richard Howey
+  Research Software Engineering, Newcastle University
+  HAT-DOCS: HTML and TeX documentation from one common source
+*/
+
+#ifndef __HATSTATS
+#define __HATSTATS
+
+#include <string>
+#include <ostream>
+#include <mutex>
+#include <chrono>
+
+//the phases of making a document that are timed
+enum HatPhase {titleScanPhase, sectionScanPhase, webpageScanPhase, referenceScanPhase, bibliographyPhase, htmlRenderPhase, texRenderPhase, searchIndexPhase, gzipPhase, fileWritePhase, noPhases};
+
+//the things that are counted
+enum HatCount {tokenCount, pageCount, figureCount, citationCount, bibLookupCount, outputByteCount, filesWrittenCount, filesUnchangedCount, noCounts};
+
+//times and counts for making a document, added to by the html and tex processing at the same time
+class HatStats
+{
+private:
+
+	double phaseSeconds[noPhases];
+	unsigned long long phaseBytes[noPhases]; //source bytes read, or bytes written for file writes
+	unsigned long long phaseCalls[noPhases];
+	unsigned long long counts[noCounts];
+	double totalSeconds;
+	mutex adding;
+
+	static const char * phaseNames[noPhases];
+	static const char * phaseKeys[noPhases];
+	static const char * countNames[noCounts];
+	static const char * countKeys[noCounts];
+
+public:
+
+	HatStats();
+
+	~HatStats()
+	{
+
+	};
+
+	void addPhase(const HatPhase & phase, const double & seconds, const unsigned long long & bytes);
+	void addCount(const HatCount & count, const unsigned long long & number);
+	void setTotalSeconds(const double & seconds) {totalSeconds = seconds;};
+	void display(ostream & out);
+	bool writeJson(const string & fileName, const string & documentName);
+};
+
+//times one phase from when it is made until end is called
+class HatPhaseTimer
+{
+private:
+
+	HatStats * stats;
+	HatPhase phase;
+	chrono::steady_clock::time_point start;
+
+public:
+
+	HatPhaseTimer(HatStats * st, const HatPhase & ph) : stats(st), phase(ph), start(chrono::steady_clock::now()) {};
+
+	~HatPhaseTimer()
+	{
+
+	};
+
+	double getSeconds() const {return chrono::duration<double>(chrono::steady_clock::now() - start).count();};
+	void end(const unsigned long long & bytes = 0) {if(stats != 0) stats->addPhase(phase, getSeconds(), bytes);};
+};
+
+#endif
@@ -0,0 +1,165 @@
+/*
+  Richard Howey
+  Research Software Engineering, Newcastle University
+  HAT-DOCS: HTML and TeX documentation from one common source
+*/
+
+#include <algorithm>
+#include <thread>
+#include <chrono>
+#include <sys/stat.h>
+#ifdef __linux__
+#include <unistd.h>
+#include <poll.h>
+#include <sys/inotify.h>
+#endif
+
+using namespace std; // initiates the "std" or "standard" namespace
+
+#include "HatWatch.h"
+
+//splits a file name into its directory and name, so that files replaced by editors are still seen
+void getDirectoryAndName(const string & fileName, string & directory, string & name)
+{
+	size_t slash = fileName.find_last_of('/');
+	if(slash == string::npos)
+	{
+		directory = ".";
+		name = fileName;
+	}
+	else
+	{
+		directory = fileName.substr(0, slash);
+		if(directory == "") directory = "/";
+		name = fileName.substr(slash + 1);
+	};
+};
+
+HatWatch::HatWatch() : watchedFiles(), fileTimes()
+#ifdef __linux__
+	, inotifyFd(inotify_init()), directories()
+#endif
+{
+
+};
+
+HatWatch::~HatWatch()
+{
+#ifdef __linux__
+	if(inotifyFd >= 0) close(inotifyFd);
+#endif
+};
+
+//the time to the nanosecond where possible and the size, to see if a file has changed without reading it
+unsigned long long HatWatch::getFileTime(const string & fileName)
+{
+	struct stat fileStatus;
+	if(stat(fileName.c_str(), &fileStatus) != 0) return 0;
+
+#ifdef __linux__
+	unsigned long long fileTime = (unsigned long long)fileStatus.st_mtim.tv_sec*1000000000ULL + fileStatus.st_mtim.tv_nsec;
+#else
+	unsigned long long fileTime = fileStatus.st_mtime;
+#endif
+
+	return fileTime ^ ((unsigned long long)fileStatus.st_size << 40);
+};
+
+//sets the files to watch, the directories of any new files are watched as well
+void HatWatch::setFiles(const list<string> & fileNames)
+{
+	string directory, name;
+
+	watchedFiles.clear();
+	fileTimes.clear();
+
+	for(list<string>::const_iterator f = fileNames.begin(); f != fileNames.end(); ++f)
+	{
+		if(*f == "") continue;
+
+		getDirectoryAndName(*f, directory, name);
+		watchedFiles[directory + "/" + name] = *f;
+		fileTimes[*f] = getFileTime(*f);
+
+#ifdef __linux__
+		bool watched = false;
+		for(map<int, string>::const_iterator d = directories.begin(); d != directories.end(); ++d)
+		{
+			if(d->second == directory) watched = true;
+		};
+
+		if(!watched && inotifyFd >= 0)
+		{
+			int wd = inotify_add_watch(inotifyFd, directory.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO | IN_CREATE | IN_DELETE);
+			if(wd >= 0) directories[wd] = directory;
+		};
+#endif
+	};
+};
+
+void HatWatch::addChangedFile(const string & path, list<string> & changedFiles)
+{
+	map<string, string>::const_iterator w = watchedFiles.find(path);
+	if(w == watchedFiles.end()) return;
+
+	if(find(changedFiles.begin(), changedFiles.end(), w->second) == changedFiles.end()) changedFiles.push_back(w->second);
+};
+
+//waits until at least one file has changed and returns the changed files, changes
+//close together, such as an editor saving several files, are returned together
+list<string> HatWatch::waitForChanges()
+{
+	list<string> changedFiles;
+
+#ifdef __linux__
+	if(inotifyFd >= 0 && !directories.empty())
+	{
+		const size_t bufferSize = 65536;
+		char buffer[bufferSize];
+		struct pollfd pollFd;
+		pollFd.fd = inotifyFd;
+		pollFd.events = POLLIN;
+
+		//wait as long as it takes for the first change, then until there are no more for a short time
+		int timeout = -1;
+
+		while(poll(&pollFd, 1, timeout) > 0)
+		{
+			ssize_t noRead = read(inotifyFd, buffer, bufferSize);
+			if(noRead <= 0) break;
+
+			for(char * e = buffer; e < buffer + noRead; )
+			{
+				struct inotify_event * event = (struct inotify_event *)e;
+				map<int, string>::const_iterator d = directories.find(event->wd);
+
+				if(d != directories.end() && event->len > 0) addChangedFile(d->second + "/" + event->name, changedFiles);
+
+				e += sizeof(struct inotify_event) + event->len;
+			};
+
+			if(!changedFiles.empty()) timeout = 100;
+		};
+
+		return changedFiles;
+	};
+#endif
+
+	//check the file times until something changes
+	while(changedFiles.empty())
+	{
+		this_thread::sleep_for(chrono::milliseconds(250));
+
+		for(map<string, unsigned long long>::iterator f = fileTimes.begin(); f != fileTimes.end(); ++f)
+		{
+			unsigned long long fileTime = getFileTime(f->first);
+			if(fileTime != f->second)
+			{
+				f->second = fileTime;
+				changedFiles.push_back(f->first);
+			};
+		};
+	};
+
+	return changedFiles;
+};
@@ -0,0 +1,38 @@
+/*
+  Richard Howey
+  Research Software Engineering, Newcastle University
+  HAT-DOCS: HTML and TeX documentation from one common source
+*/
+
+#ifndef __HATWATCH
+#define __HATWATCH
+
+#include <string>
+#include <list>
+#include <map>
+
+//waits for any of a list of files to change, using inotify on linux and otherwise checking the file times
+class HatWatch
+{
+private:
+
+	map<string, string> watchedFiles; //path as directory/name, file name as given
+	map<string, unsigned long long> fileTimes; //file name, time and size last seen
+#ifdef __linux__
+	int inotifyFd;
+	map<int, string> directories; //watch descriptor, directory
+#endif
+
+	unsigned long long getFileTime(const string & fileName);
+	void addChangedFile(const string & path, list<string> & changedFiles);
+
+public:
+
+	HatWatch();
+	~HatWatch();
+
+	void setFiles(const list<string> & fileNames);
+	list<string> waitForChanges();
+};
+
+#endif
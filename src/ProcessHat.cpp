@@ -9,22 +9,120 @@
 #include <ostream>
 #include <list>
 #include <map>
-#include <set>
 #include <cstdlib>
+#include <thread>
+#include <algorithm>
 
 using namespace std; // initiates the "std" or "standard" namespace
  
 #include "ProcessHat.h"
 
-void ProcessHat::processWord(string & word, ifstream & fileIn, ostream & fileOut)
+//finds the command for a word by its length and then its first chars, most words are not commands and only need one or two chars checked
+HatCommand getCommand(const string & word)
+{
+	unsigned int length = word.length();
+	if(length < 3 || word[0] != '*' || word[length - 1] != '*') return notCommand;
+
+	switch(length)
+	{
+		case 3:
+			if(word[1] == 'b') return boldCommand;
+			else if(word[1] == 'i') return italicCommand;
+			else if(word[1] == 'u') return underlineCommand;
+			else if(word[1] == 'q') return quoteCommand;
+			break;
+		case 4:
+			if(word[1] != '/') break;
+			if(word[2] == 'b') return boldEndCommand;
+			else if(word[2] == 'i') return italicEndCommand;
+			else if(word[2] == 'u') return underlineEndCommand;
+			else if(word[2] == 'q') return quoteEndCommand;
+			break;
+		case 5:
+			if(word == "*ref*") return refCommand;
+			else if(word == "*tex*") return texCommand;
+			break;
+		case 6:
+			switch(word[1])
+			{
+				case 'h': if(word == "*html*") return htmlCommand; break;
+				case 'l': if(word == "*list*") return listCommand; else if(word == "*logo*") return commentCommand; break;
+				case 's': if(word == "*star*") return starCommand; break;
+				case 'c': if(word == "*code*") return codeCommand; else if(word == "*cite*") return citeCommand; break;
+				case 'd': if(word == "*date*") return commentCommand; break;
+			};
+			break;
+		case 7:
+			switch(word[1])
+			{
+				case 't': if(word == "*title*") return commentCommand; else if(word == "*table*") return tableCommand; break;
+				case 'i': if(word == "*input*") return inputCommand; break;
+				case '/': if(word == "*/code*") return codeEndCommand; else if(word == "*/cite*") return citeEndCommand; break;
+			};
+			break;
+		case 8:
+			switch(word[1])
+			{
+				case 'a': if(word == "*author*") return commentCommand; break;
+				case 'f': if(word == "*figref*") return figRefCommand; else if(word == "*figure*") return figureCommand; break;
+				case 'd': if(word == "*dollar*") return dollarCommand; break;
+				case 't':
+					if(word.compare(0, 6, "*table") != 0) break;
+					if(word[6] == 'r') return tablerCommand;
+					else if(word[6] == 'l') return tablelCommand;
+					else if(word[6] == 'c') return tablecCommand;
+					break;
+			};
+			break;
+		case 9:
+			switch(word[1])
+			{
+				case 's': if(word == "*section*") return sectionCommand; break;
+				case 'w': if(word == "*webpage*") return webpageCommand; break;
+				case 'c': if(word == "*comment*") return commentCommand; break;
+				case 'a': if(word == "*address*") return commentCommand; break;
+				case 'n': if(word == "*numlist*") return numListCommand; break;
+				case 'p': if(word == "*percent*") return percentCommand; break;
+			};
+			break;
+		case 10:
+			if(word == "*section2*") return section2Command;
+			else if(word == "*subtitle*" || word == "*abstract*") return commentCommand;
+			break;
+		case 11:
+			if(word == "*stylefile*" || word == "*logowidth*") return commentCommand;
+			else if(word == "*tableropt*") return tableroptCommand;
+			else if(word == "*tablelopt*") return tableloptCommand;
+			else if(word == "*tablecopt*") return tablecoptCommand;
+			break;
+		case 13:
+			if(word == "*codeexample*") return codeExampleCommand;
+			break;
+		case 19:
+			if(word == "*codeexample-small*") return codeExampleSmallCommand;
+			break;
+	};
+
+	return notCommand;
+};
+
+void ProcessHat::processWord(string & word, HatStream & fileIn, ostream & fileOut)
 {	
-	if(word.length() >= 2 && word.substr(0, 2) == "**") return;  //ignore lines of *'s
+	//ordinary words have no commands or formulas so are written straight out
+	if(word.length() >= 1 && word.find_first_of("*$") == string::npos)
+	{
+		fileOut << word;
+		if(!nextWordIsEndWord(fileIn)) fileOut << " ";
+		return;
+	};
+
+	if(word.length() >= 2 && word.compare(0, 2, "**") == 0) return;  //ignore lines of *'s
 
 	trimStartWord(word, fileIn, fileOut);
 	string endTrim;
 	bool formula = false;
 
-	if(word.substr(0, 1) == "$")
+	if(word.compare(0, 1, "$") == 0)
 	{
 		pair<string, string> formulaEndBit = getLatexFormula(word, fileIn, fileOut);
 		word = formulaEndBit.first;
@@ -36,7 +134,7 @@ void ProcessHat::processWord(string & word, ifstream & fileIn, ostream & fileOut
 	if(!formula) endTrim = trimEndWord(word, fileIn, fileOut);
 
 	//single quoted word
-	if(word.length() >= 7 && word.substr(0, 3) == "*q*" && word.substr((word.length() - 4)) == "*/q*")
+	if(word.length() >= 7 && word.compare(0, 3, "*q*") == 0 && word.compare(word.length() - 4, 4, "*/q*") == 0)
 	{
 		processQuoteOneWord(word, fileIn, fileOut);
 		if(endTrim != "") fileOut << endTrim;
@@ -44,74 +142,82 @@ void ProcessHat::processWord(string & word, ifstream & fileIn, ostream & fileOut
 		return;
 	};
 
-	//if(verbose) cout << word << " ";	
+	//if(verbose) *logOut << word << " ";	
 
+	HatCommand command = notCommand;
 	if(formula) processLatexFormula(word, fileIn, fileOut);
-	else if(word == "*section*")
-	{	
-		unsigned int depth = 0;
-		processSection(fileIn, fileOut, depth);
-	}	
-	else if(word == "*section2*")
-	{
-		subSectionsOnNewPage = true;
-		unsigned int depth = 0;
-		processSection(fileIn, fileOut, depth);
-		subSectionsOnNewPage = false;
-	}
-	else if(word == "*webpage*") processWebpage(fileIn, fileOut);
-	else if(word == "*comment*" || word == "*title*" || word == "*subtitle*" || word == "*author*" || word == "*address*" || word == "*date*" || word == "*abstract*" || word == "*stylefile*" || word == "*logo*" || word == "*logowidth*" ) processComment(fileIn);
-	else if(word == "*html*") processHtml(fileIn, fileOut);
-	else if(word == "*tex*") processTex(fileIn, fileOut);	
-	else if(word == "*codeexample*") processCodeExample(fileIn, fileOut);
-	else if(word == "*codeexample-small*") processCodeExampleSmall(fileIn, fileOut);
-	else if(word == "*list*") processList(fileIn, fileOut, false);
-	else if(word == "*numlist*") processList(fileIn, fileOut, true);
-	else if(word == "*table*") processTable(fileIn, fileOut);
-	else if(word == "*tabler*") processTable(fileIn, fileOut, 1);
-	else if(word == "*tablel*") processTable(fileIn, fileOut, 2);
-	else if(word == "*tablec*") processTable(fileIn, fileOut, 3);
-	else if(word == "*tableropt*") processTable(fileIn, fileOut, 1, true);
-	else if(word == "*tablelopt*") processTable(fileIn, fileOut, 2, true);
-	else if(word == "*tablecopt*") processTable(fileIn, fileOut, 3, true);
-	else if(word == "*ref*") processRef(fileIn, fileOut);
-	else if(word == "*figref*") processFigRef(fileIn, fileOut);
-	else if(word == "*figure*") processFigure(fileIn, fileOut);
-	else if(word == "*star*") fileOut << "*";
-	else if(word == "*dollar*") fileOut << "$";
-	else if(word == "*code*") processCode(fileIn, fileOut, true);
-	else if(word == "*/code*") processCode(fileIn, fileOut, false);	
-	else if(word == "*b*") processBold(word, fileIn, fileOut, true);
-	else if(word == "*/b*") processBold(word, fileIn, fileOut, false);
-	else if(word == "*i*") processItalic(word, fileIn, fileOut, true);
-	else if(word == "*/i*") processItalic(word, fileIn, fileOut, false);
-	else if(word == "*u*") processUnderline(word, fileIn, fileOut, true);
-	else if(word == "*/u*") processUnderline(word, fileIn, fileOut, false);	
-	else if(word == "*q*") processQuote(fileIn, fileOut, true);
-	else if(word == "*/q*") processQuote(fileIn, fileOut, false);
-	else if(word == "*cite*") processCite(fileIn, fileOut, true);
-	else if(word == "*/cite*") processCite(fileIn, fileOut, false);
-	else if(word == "*percent*") processPercent(fileIn, fileOut);
-	else if(word == "*input*") processInput(fileIn, fileOut);
 	else
 	{
-		fileOut << word;
+		command = getCommand(word);
+
+		switch(command)
+		{
+			case sectionCommand:
+			{
+				unsigned int depth = 0;
+				processSection(fileIn, fileOut, depth);
+				break;
+			}
+			case section2Command:
+			{
+				subSectionsOnNewPage = true;
+				unsigned int depth = 0;
+				processSection(fileIn, fileOut, depth);
+				subSectionsOnNewPage = false;
+				break;
+			}
+			case webpageCommand: processWebpage(fileIn, fileOut); break;
+			case commentCommand: processComment(fileIn); break;
+			case htmlCommand: processHtml(fileIn, fileOut); break;
+			case texCommand: processTex(fileIn, fileOut); break;
+			case codeExampleCommand: processCodeExample(fileIn, fileOut); break;
+			case codeExampleSmallCommand: processCodeExampleSmall(fileIn, fileOut); break;
+			case listCommand: processList(fileIn, fileOut, false); break;
+			case numListCommand: processList(fileIn, fileOut, true); break;
+			case tableCommand: processTable(fileIn, fileOut); break;
+			case tablerCommand: processTable(fileIn, fileOut, 1); break;
+			case tablelCommand: processTable(fileIn, fileOut, 2); break;
+			case tablecCommand: processTable(fileIn, fileOut, 3); break;
+			case tableroptCommand: processTable(fileIn, fileOut, 1, true); break;
+			case tableloptCommand: processTable(fileIn, fileOut, 2, true); break;
+			case tablecoptCommand: processTable(fileIn, fileOut, 3, true); break;
+			case refCommand: processRef(fileIn, fileOut); break;
+			case figRefCommand: processFigRef(fileIn, fileOut); break;
+			case figureCommand: processFigure(fileIn, fileOut); break;
+			case starCommand: fileOut << "*"; break;
+			case dollarCommand: fileOut << "$"; break;
+			case codeCommand: processCode(fileIn, fileOut, true); break;
+			case codeEndCommand: processCode(fileIn, fileOut, false); break;
+			case boldCommand: processBold(word, fileIn, fileOut, true); break;
+			case boldEndCommand: processBold(word, fileIn, fileOut, false); break;
+			case italicCommand: processItalic(word, fileIn, fileOut, true); break;
+			case italicEndCommand: processItalic(word, fileIn, fileOut, false); break;
+			case underlineCommand: processUnderline(word, fileIn, fileOut, true); break;
+			case underlineEndCommand: processUnderline(word, fileIn, fileOut, false); break;
+			case quoteCommand: processQuote(fileIn, fileOut, true); break;
+			case quoteEndCommand: processQuote(fileIn, fileOut, false); break;
+			case citeCommand: processCite(fileIn, fileOut, true); break;
+			case citeEndCommand: processCite(fileIn, fileOut, false); break;
+			case percentCommand: processPercent(fileIn, fileOut); break;
+			case inputCommand: processInput(fileIn, fileOut); break;
+			default: fileOut << word;
+		};
 	};
 
 	if(endTrim != "") fileOut << endTrim;
 	
 	//a space if not after a beginning or before the end of a command
 	if(!nextWordIsEndWord(fileIn) &&
-		((word.substr(0, 1) != "*" && word.substr((word.length() - 1), 1) != "*")
+		((word.length() >= 1 && word[0] != '*' && word[word.length() - 1] != '*')
 		||
-		(word == "*percent*" || word == "*star*")
+		(command == percentCommand || command == starCommand)
 		||
-		(word == "*q*" && endTrim != "")
+		(command == quoteCommand && endTrim != "")
 		||
-		(word.length() >= 2 && word.substr(0, 2) == "*/"))) fileOut << " ";
+		(word.length() >= 2 && word.compare(0, 2, "*/") == 0))) fileOut << " ";
 };
 
-void ProcessHtml::processWord(string & word, ifstream & fileIn, ostream & fileOut, bool replaceChars)
+void ProcessHtml::processWord(string & word, HatStream & fileIn, ostream & fileOut, bool replaceChars)
 {
 	if(replaceChars && !processingWebpage) replaceSpecialChars(word);
 
@@ -124,54 +230,297 @@ void ProcessHat::process(string & filename)
 	if(texFileName != "") fileOutName = texFileName;
 	else fileOutName = getFileOutName(filename);
 
-	ifstream fileIn(filename.c_str());
-	ofstream fileOut(fileOutName.c_str());
+	//the tex file only depends on the source files, so leave it if none of them have changed
+	string keyText;
+	appendString(keyText, filename);
+	appendString(keyText, fileOutName);
+	appendString(keyText, bibFileName);
+	addBuildKey(keyText);
+
+	BuildRecord record;
+	string outputName = "tex " + fileOutName;
+	if(document->getPreviousBuild(outputName, getTextHash(keyText), record, output))
+	{
+		if(verbose) *logOut << "\n\nTEX file unchanged: " << fileOutName << "\n";
+		filesCreated.insert(filesCreated.end(), record.filesCreated.begin(), record.filesCreated.end());
+		noFilesUnchanged += record.filesCreated.size();
+		*warningOut << record.warnings;
+		return;
+	};
+
+	HatStream fileIn(getFile(filename));
+	ostringstream fileOut;
 
 	if(!fileIn.is_open())
 	{
-		cerr<<"Cannot read file: "<<filename<< "!\n";
-		exit(1);
+		*warningOut<<"Cannot read file: "<<filename<< "!\n";
+		throw HatError();
 	};
 
-	if(verbose) cout << "\n\nProcessing TEX: " << filename << "\n";
-	if(verbose) cout << "Adding title data\n";
-	addTitleData(filename, fileOut);
-	unsigned int sectionCount = 1;
-	unsigned int figureNumber = 1;
-	if(verbose) cout << "Adding section data\n";
-	addSectionData(filename, fileOut, sectionCount, figureNumber);
+	//keep the warnings to give again if the file is left as it is in the next build
+	ostream * fileWarningOut = warningOut;
+	ostringstream fileWarnings;
+	warningOut = &fileWarnings;
+
+	//a fatal error is shown after the warnings of the file
+	try
+	{
+		if(verbose) *logOut << "\n\nProcessing TEX: " << filename << "\n";
+		if(verbose) *logOut << "Adding title data\n";
+		size_t noFilesReadBefore = filesRead.size();
+		HatPhaseTimer titleTimer(stats, titleScanPhase);
+		addTitleData(filename, fileOut);
+		titleTimer.end(getBytesRead(noFilesReadBefore));
+
+		unsigned int sectionCount = 1;
+		unsigned int figureNumber = 1;
+		if(verbose) *logOut << "Adding section data\n";
+		noFilesReadBefore = filesRead.size();
+		HatPhaseTimer sectionTimer(stats, sectionScanPhase);
+		addSectionData(filename, fileOut, sectionCount, figureNumber);
+		sectionTimer.end(getBytesRead(noFilesReadBefore));
+
+		filesCreated.push_back(fileOutName);
+	
+		//the main file has already been read so count all of the files
+		HatPhaseTimer renderTimer(stats, texRenderPhase);
+		processFile(fileIn, fileOut);
+		writeFile(fileOutName, fileOut.str());
+		renderTimer.end(getBytesRead(0));
+	}
+	catch(HatError &)
+	{
+		warningOut = fileWarningOut;
+		*warningOut << fileWarnings.str();
+		throw;
+	};
 
-	filesCreated.push_back(fileOutName);
-	
-	processFile(fileIn, fileOut);
+	warningOut = fileWarningOut;
+	*warningOut << fileWarnings.str();
+
+	if(noFilesNotWritten > 0) return;
+
+	record.key = getTextHash(keyText);
+	record.filesCreated = filesCreated;
+	record.warnings = fileWarnings.str();
+	getFilesRead(record, 0);
+	document->addBuild(outputName, record);
+};
+
+//writes an output file unless it is the same as before
+void ProcessHat::writeFile(const string & fileName, const string & text)
+{
+	HatPhaseTimer writeTimer(stats, fileWritePhase);
+	HatWriteResult result = output->writeFile(fileName, text);
+	bool written = result == fileWritten;
+
+	if(result == fileUnchanged) noFilesUnchanged++;
+	else if(result == fileNotWritten)
+	{
+		//the file is not listed as created, so it is not taken as up to date in the next build
+		*warningOut << "Cannot write file: " << output->getPath(fileName) << "!\n";
+		noFilesNotWritten++;
+		list<string>::iterator f = find(filesCreated.begin(), filesCreated.end(), fileName);
+		if(f != filesCreated.end()) filesCreated.erase(f);
+	};
+
+	if(stats != 0)
+	{
+		writeTimer.end(written ? text.length() : 0);
+		stats->addCount(outputByteCount, text.length());
+		stats->addCount(written ? filesWrittenCount : filesUnchangedCount, 1);
+	};
+
+	size_t length = fileName.length();
+	if((length > 5 && fileName.compare(length - 5, 5, ".html") == 0) || (length > 3 && fileName.compare(length - 3, 3, ".js") == 0)) writeGzipFile(fileName, text);
+};
+
+//pages and scripts have a compressed copy for web servers to send as it is, which is only written if it changes,
+//a copy left from a build with gzip is removed if there is none now so that it is never older than the page
+void ProcessHat::writeGzipFile(const string & fileName, const string & text)
+{
+	string gzipFileName = fileName + ".gz";
+
+	if(gzipLevel == 0)
+	{
+		if(output->hasFile(gzipFileName)) output->removeFile(gzipFileName);
+		return;
+	};
+
+	HatPhaseTimer gzipTimer(stats, gzipPhase);
+	string compressed;
+	bool compressedOk = getGzipText(text, compressed, gzipLevel);
+	gzipTimer.end(text.length());
+
+	if(!compressedOk)
+	{
+		*warningOut << "Warning: cannot compress file: " << fileName << "!\n";
+		return;
+	};
+
+	filesCreated.push_back(gzipFileName);
+	writeFile(gzipFileName, compressed);
+};
+
+//gets a source file of the document, noting that it has been read
+HatFile * ProcessHat::getFile(const string & filename)
+{
+	filesRead.push_back(filename);
+
+	return document->getFile(filename);
+};
+
+//the size of the files read since the given number of files had been read, each file is only counted once
+unsigned long long ProcessHat::getBytesRead(size_t noFilesBefore)
+{
+	if(stats == 0) return 0;
+
+	list<string>::const_iterator f = filesRead.begin();
+	for(size_t i = 0; i < noFilesBefore && f != filesRead.end(); ++i) ++f;
+
+	map<string, unsigned long long> fileSizes;
+	for( ; f != filesRead.end(); ++f)
+	{
+		HatFile * hatFile = document->getFile(*f);
+		if(hatFile != 0) fileSizes[*f] = hatFile->text.length();
+	};
+
+	unsigned long long noBytes = 0;
+	for(map<string, unsigned long long>::const_iterator fs = fileSizes.begin(); fs != fileSizes.end(); ++fs)
+	{
+		noBytes += fs->second;
+	};
+
+	return noBytes;
+};
+
+//the number of words in all of the source files read
+unsigned long long ProcessHat::getNoWordsRead()
+{
+	map<string, unsigned long long> fileWords;
+	for(list<string>::const_iterator f = filesRead.begin(); f != filesRead.end(); ++f)
+	{
+		HatFile * hatFile = document->getFile(*f);
+		if(hatFile != 0) fileWords[*f] = hatFile->getNoWords();
+	};
+
+	unsigned long long noWords = 0;
+	for(map<string, unsigned long long>::const_iterator fw = fileWords.begin(); fw != fileWords.end(); ++fw)
+	{
+		noWords += fw->second;
+	};
+
+	return noWords;
+};
+
+//adds the files read since the given number of files had been read to what an output depends on
+void ProcessHat::getFilesRead(BuildRecord & record, size_t noFilesBefore)
+{
+	list<string>::const_iterator f = filesRead.begin();
+	for(size_t i = 0; i < noFilesBefore && f != filesRead.end(); ++i) ++f;
+
+	for( ; f != filesRead.end(); ++f)
+	{
+		HatFile * hatFile = document->getFile(*f);
+		if(hatFile != 0) record.filesRead[*f] = hatFile->hash;
+	};
 };
 
 void ProcessHtml::process(string & filename)
 {	
-	ifstream fileIn(filename.c_str());
+	HatStream fileIn(getFile(filename));
 	ofstream fileOut;
 
 	if(!fileIn.is_open())
 	{
-		cerr<<"Cannot read file: "<<filename<< "!\n";
-		exit(1);
+		*warningOut<<"Cannot read file: "<<filename<< "!\n";
+		throw HatError();
 	};
 
-	if(verbose) cout << "Processing HTML: " << filename << "\n\n";
+	if(verbose) *logOut << "Processing HTML: " << filename << "\n\n";
+
+	addFooterText();
 
+	size_t noFilesReadBefore = filesRead.size();
+	HatPhaseTimer titleTimer(stats, titleScanPhase);
 	addTitleData(filename, fileOut);
+	titleTimer.end(getBytesRead(noFilesReadBefore));
+
 	unsigned int sectionCount = 1;
 	unsigned int figureNumber = 1;
+	noFilesReadBefore = filesRead.size();
+	HatPhaseTimer sectionTimer(stats, sectionScanPhase);
 	addSectionData(filename, fileOut, sectionCount, figureNumber);
+	addPageOrder();
+	sectionTimer.end(getBytesRead(noFilesReadBefore));
+
+	noFilesReadBefore = filesRead.size();
+	HatPhaseTimer webpageTimer(stats, webpageScanPhase);
 	addWebpageData(filename, fileOut);
+	webpageTimer.end(getBytesRead(noFilesReadBefore));
+
+	noFilesReadBefore = filesRead.size();
+	HatPhaseTimer referenceTimer(stats, referenceScanPhase);
 	addReferences(filename, fileOut);
+	referenceTimer.end(getBytesRead(noFilesReadBefore));
+
+	noFilesReadBefore = filesRead.size();
+	HatPhaseTimer renderTimer(stats, htmlRenderPhase);
+	addHeaderText(fileIn);
+	addNavigationKey();
 	addReferencesWebpage(fileIn, fileOut);
+	addContentsFiles(fileIn);
+
+	//section pages are written in other threads once the main pass is done, if that goes wrong write them all here
+	list<string> filesCreatedBefore = filesCreated;
+	unsigned int noFilesUnchangedBefore = noFilesUnchanged;
+	unsigned int noFilesNotWrittenBefore = noFilesNotWritten;
+	string logBefore = collectedLog.str();
+	string warningsBefore = collectedWarnings.str();
+	processPages(filename, fileOut);
+
+	if(!processPageJobs())
+	{
+		filesCreated = filesCreatedBefore;
+		noFilesUnchanged = noFilesUnchangedBefore;
+		noFilesNotWritten = noFilesNotWrittenBefore;
+		collectedLog.str(logBefore);
+		collectedLog.seekp(0, ios_base::end);
+		collectedWarnings.str(warningsBefore);
+		collectedWarnings.seekp(0, ios_base::end);
+		noThreads = 1;
+		processPages(filename, fileOut);
+	};
+
+	renderTimer.end(getBytesRead(noFilesReadBefore));
+
+	if(search)
+	{
+		noFilesReadBefore = filesRead.size();
+		HatPhaseTimer searchTimer(stats, searchIndexPhase);
+		addSearchWebpage(filename, fileIn);
+		searchTimer.end(getBytesRead(noFilesReadBefore));
+	};
+
+	if(stats != 0)
+	{
+		stats->addCount(tokenCount, getNoWordsRead());
+		stats->addCount(pageCount, filesCreated.size());
+		stats->addCount(figureCount, figures.size());
+		stats->addCount(citationCount, citations.size());
+	};
+};
+
+//writes index.html and any pages found in it, section pages may be left as jobs for other threads
+void ProcessHtml::processPages(string & filename, ofstream & fileOut)
+{
+	HatStream fileIn(getFile(filename));
 
 	string word;
 	fileIn >> word;
 		
 	do{
-		if(verbose) cout << word << " ";
+		if(verbose) *logOut << word << " ";
 		processWord(word, fileIn, fileOut);
 		
 		if(!fileIn.eof()) fileIn >> word;
@@ -181,7 +530,201 @@ void ProcessHtml::process(string & filename)
 	
 	fileIn.close();
 	fileOut.close();
+};
+
+//hashes everything that goes on every section page, so a page need not be written again if this and the source of the section are the same
+void ProcessHtml::addNavigationKey()
+{
+	string keyText;
+	appendString(keyText, headerText);
+	appendString(keyText, footerText);
+	appendNumber(keyText, subSectionsOnNewPage);
+	appendNumber(keyText, search);
+	appendNumber(keyText, gzipLevel);
+	appendNumber(keyText, minify);
+	appendNumber(keyText, sharedNavigation);
+
+	for(map<string, string>::const_iterator f = figures.begin(); f != figures.end(); ++f)
+	{
+		appendString(keyText, f->first);
+		appendString(keyText, f->second);
+	};
+
+	for(map<string, Section * >::const_iterator s = sections.begin(); s != sections.end(); ++s)
+	{
+		appendString(keyText, s->first);
+		appendString(keyText, s->second->number);
+		appendString(keyText, s->second->title);
+		appendString(keyText, s->second->nameUpperSection);
+		appendNumber(keyText, s->second->newPageForSubsections);
+		appendNumber(keyText, s->second->hasPageOrder);
+		if(s->second->prevPage != 0) appendString(keyText, s->second->prevPage->name); else appendString(keyText, "");
+		if(s->second->nextPage != 0) appendString(keyText, s->second->nextPage->name); else appendString(keyText, "");
+	};
+
+	for(map<string, Citation *>::const_iterator c = citations.begin(); c != citations.end(); ++c)
+	{
+		appendCitation(keyText, c->second);
+	};
+
+	navigationKey = getTextHash(keyText);
+};
+
+//finds the section of a section page if the source of the section is where it was found when adding the section data
+Section * ProcessHtml::getPageSection(string & sectionName, HatStream & fileIn)
+{
+	map<string, Section * >::const_iterator s = sections.find(sectionName);
+	if(s == sections.end() || s->second->sourceFile != fileIn.getFile() || s->second->sourceStart != fileIn.getPosition()) return 0;
+
+	return s->second;
+};
+
+unsigned long long ProcessHtml::getPageKey(Section * section)
+{
+	string keyText;
+	appendNumber(keyText, navigationKey);
+	appendString(keyText, section->name);
+	appendString(keyText, section->sourceFile->name);
+	appendString(keyText, section->sourceFile->text.substr(section->sourceStart, section->sourceEnd - section->sourceStart));
+
+	return getTextHash(keyText);
+};
+
+//skips over a section page that is the same as in the last build
+bool ProcessHtml::skipSectionPage(string & sectionName, HatStream & fileIn)
+{
+	Section * section = getPageSection(sectionName, fileIn);
+	if(section == 0) return false;
+
+	BuildRecord record;
+	if(!document->getPreviousBuild("html " + sectionName, getPageKey(section), record, output)) return false;
+
+	if(verbose) *logOut << "\nHTML section page unchanged: " << sectionName << "\n";
+	filesCreated.insert(filesCreated.end(), record.filesCreated.begin(), record.filesCreated.end());
+	noFilesUnchanged += record.filesCreated.size();
+	*warningOut << record.warnings;
+
+	fileIn.moveTo(section->sourceEnd);
 
+	return true;
+};
+
+//leaves a section page to be written later in another thread, the source of the section must be
+//where it was found when adding the section data as the section is skipped over here
+bool ProcessHtml::addPageJob(string & sectionName, string & sectionTitle, HatStream & fileIn)
+{
+	//the messages of the page are put in with the others afterwards so they must be collected
+	if(noThreads <= 1 || logOut != &collectedLog) return false;
+
+	Section * section = getPageSection(sectionName, fileIn);
+	if(section == 0) return false;
+
+	filesCreated.push_back("");
+	list<string>::iterator fileNamePos = filesCreated.end();
+	--fileNamePos;
+
+	pageJobs.push_back(new PageJob(new ProcessHtml(*this), fileIn, sectionName, sectionTitle, section->sourceEnd, fileNamePos, collectedLog.tellp(), collectedWarnings.tellp()));
+
+	fileIn.moveTo(section->sourceEnd);
+
+	return true;
+};
+
+void ProcessHtml::processPageJobsThread(unsigned int * nextJob, mutex * jobLock)
+{
+	unsigned int jobNo;
+
+	while(true)
+	{
+		{
+			lock_guard<mutex> lock(*jobLock);
+			jobNo = (*nextJob)++;
+		};
+
+		if(jobNo >= pageJobs.size()) return;
+
+		PageJob * job = pageJobs[jobNo];
+
+		//an error cannot be passed out of the thread, so it is passed on once all of the pages are done
+		try
+		{
+			job->renderer->processSectionPage(job->sectionName, job->sectionTitle, job->fileIn, 0);
+		}
+		catch(HatError &)
+		{
+			job->failed = true;
+		};
+	};
+};
+
+//writes the section pages left as jobs, returns false if any page did not end where the main pass carried on from,
+//a fatal error on any page is passed on after the messages of all of the pages are collected
+bool ProcessHtml::processPageJobs()
+{
+	unsigned int nextJob = 0;
+	mutex jobLock;
+	unsigned int noJobThreads = noThreads;
+	if(noJobThreads > pageJobs.size()) noJobThreads = pageJobs.size();
+
+	list<thread> jobThreads;
+	for(unsigned int t = 1; t < noJobThreads; ++t)
+	{
+		jobThreads.push_back(thread(&ProcessHtml::processPageJobsThread, this, &nextJob, &jobLock));
+	};
+
+	processPageJobsThread(&nextJob, &jobLock);
+
+	for(list<thread>::iterator t = jobThreads.begin(); t != jobThreads.end(); ++t)
+	{
+		t->join();
+	};
+
+	//put the files and messages of each page in the order they would have been written without threads
+	bool allPagesEnded = true;
+	bool failed = false;
+	string log = collectedLog.str();
+	string warnings = collectedWarnings.str();
+	string allLog, allWarnings;
+	size_t logPos = 0, warningPos = 0;
+
+	for(vector<PageJob *>::iterator pj = pageJobs.begin(); pj != pageJobs.end(); ++pj)
+	{
+		if((*pj)->fileIn.getPosition() != (*pj)->sourceEnd) allPagesEnded = false;
+		if((*pj)->failed) failed = true;
+
+		filesCreated.splice((*pj)->fileNamePos, (*pj)->renderer->filesCreated);
+		filesCreated.erase((*pj)->fileNamePos);
+		noFilesUnchanged += (*pj)->renderer->noFilesUnchanged;
+		noFilesNotWritten += (*pj)->renderer->noFilesNotWritten;
+		filesRead.splice(filesRead.end(), (*pj)->renderer->filesRead);
+
+		allLog.append(log, logPos, (*pj)->logPos - logPos);
+		allLog += (*pj)->renderer->collectedLog.str();
+		logPos = (*pj)->logPos;
+
+		allWarnings.append(warnings, warningPos, (*pj)->warningPos - warningPos);
+		allWarnings += (*pj)->renderer->collectedWarnings.str();
+		warningPos = (*pj)->warningPos;
+
+		delete *pj;
+	};
+
+	if(!pageJobs.empty())
+	{
+		allLog.append(log, logPos, string::npos);
+		allWarnings.append(warnings, warningPos, string::npos);
+
+		collectedLog.str(allLog);
+		collectedLog.seekp(0, ios_base::end);
+		collectedWarnings.str(allWarnings);
+		collectedWarnings.seekp(0, ios_base::end);
+	};
+
+	pageJobs.clear();
+
+	if(failed) throw HatError();
+
+	return allPagesEnded;
 };
 
 string ProcessHtml::getFileOutName(string & filename)
@@ -195,7 +738,36 @@ string ProcessTex::getFileOutName(string & filename)
 	return filename.substr(0,length-4) + ".tex";
 };
 
-void ProcessHat::processFile(ifstream & fileIn, ofstream & fileOut)
+void ProcessTex::process(string & filename)
+{
+	string fileOutName;
+	if(texFileName != "") fileOutName = texFileName;
+	else fileOutName = getFileOutName(filename);
+
+	if(fileOutName.length() > 4 && fileOutName.compare(fileOutName.length() - 4, 4, ".tex") == 0) fileOutBase = fileOutName.substr(0, fileOutName.length() - 4);
+	else fileOutBase = fileOutName;
+
+	sectionFileNames.clear();
+
+	ProcessHat::process(filename);
+};
+
+//the tex file is not the same when split, so it must not be left as made by a build that was not split
+void ProcessTex::addBuildKey(string & keyText)
+{
+	if(splitTex) appendString(keyText, "split");
+};
+
+//the name of a file as given to \include or \input, which is relative to the directory of the main tex file
+string ProcessTex::getIncludeName(const string & name)
+{
+	size_t slash = fileOutBase.find_last_of(pathSeparators);
+	if(slash == string::npos) return fileOutBase + "-" + name;
+
+	return fileOutBase.substr(slash + 1) + "-" + name;
+};
+
+void ProcessHat::processFile(HatStream & fileIn, ostream & fileOut)
 {
 	
 	header(fileIn, fileOut);
@@ -203,20 +775,19 @@ void ProcessHat::processFile(ifstream & fileIn, ofstream & fileOut)
 	fileIn >> word;
 
 	do{
-		if(verbose) cout << word << "\n";
+		if(verbose) *logOut << word << "\n";
 		processWord(word, fileIn, fileOut);
 		if(!fileIn.eof()) fileIn >> word;
 
 	}while(!fileIn.eof() && fileIn.good());
 
-	if(verbose) cout << "Adding footer\n";	
+	if(verbose) *logOut << "Adding footer\n";	
 	footer(fileIn, fileOut);
 
 	fileIn.close();
-	fileOut.close();
 };
 
-void ProcessHat::processInputFile(ifstream & fileIn, ostream & fileOut)
+void ProcessHat::processInputFile(HatStream & fileIn, ostream & fileOut)
 {	
 	string word;
 	fileIn >> word;
@@ -231,17 +802,17 @@ void ProcessHat::processInputFile(ifstream & fileIn, ostream & fileOut)
 	fileIn.close();
 };
 
-void ProcessHat::processInput(ifstream & fileIn, ostream & fileOut)
+void ProcessHat::processInput(HatStream & fileIn, ostream & fileOut)
 {
 	string filename;
 	fileIn >> filename;
 
-	ifstream newInputFileIn(filename.c_str());
+	HatStream newInputFileIn(getFile(filename));
 
 	if(!newInputFileIn.is_open())
 	{
-		cerr<<"Cannot read input file: "<<filename<< "!\n";
-		exit(1);
+		*warningOut<<"Cannot read input file: "<<filename<< "!\n";
+		throw HatError();
 	};
 
 	processInputFile(newInputFileIn, fileOut);
@@ -249,24 +820,24 @@ void ProcessHat::processInput(ifstream & fileIn, ostream & fileOut)
 	fileIn >> filename;
 	if(filename != "*/input*")
 	{
-		cerr<<"Input command not ended properly for file: "<<filename<< "!\n";
-		exit(1);
+		*warningOut<<"Input command not ended properly for file: "<<filename<< "!\n";
+		throw HatError();
 	};
 
 	newInputFileIn.close();
 };
 
-void ProcessHtml::getSectionNameAndTitle(ifstream & fileIn, ostream & fileOut, string & sectionName, string & sectionTitle)
+void ProcessHtml::getSectionNameAndTitle(HatStream & fileIn, ostream & fileOut, string & sectionName, string & sectionTitle)
 {
 	string word;
 
 	fileIn >> word;
 	if(!(word == "*section-name*" || word == "*subsection-name*" || word == "*subsubsection-name*"))
 	{
-		cerr << "Incorrect word: "<<word<<"\n";
-		cerr << "A section name must follow the beginning of a section!\n";
+		*warningOut << "Incorrect word: "<<word<<"\n";
+		*warningOut << "A section name must follow the beginning of a section!\n";
 		//fileOut.close();
-		exit(1);
+		throw HatError();
 	};
 
 	sectionName = getText(fileIn);
@@ -293,10 +864,10 @@ void ProcessHtml::getSectionNameAndTitle(ifstream & fileIn, ostream & fileOut, s
 	if(!(word == "*section-title*" || word == "*subsection-title*" || word == "*subsubsection-title*"
 		|| word == "*section-title-html*" || word == "*subsection-title-html*" || word == "*subsubsection-title-html*"))
 	{
-		cerr << "Incorrect word: "<<word<<"\n";
-		cerr << "A section title must follow the section name!\n";
+		*warningOut << "Incorrect word: "<<word<<"\n";
+		*warningOut << "A section title must follow the section name!\n";
 		//fileOut.close();
-		exit(1);
+		throw HatError();
 	};
 
 	sectionTitle = getText(fileIn);
@@ -310,17 +881,17 @@ void ProcessHtml::getSectionNameAndTitle(ifstream & fileIn, ostream & fileOut, s
 	};
 };
 
-void ProcessTex::getSectionNameAndTitle(ifstream & fileIn, ostream & fileOut, string & sectionName, string & sectionTitle)
+void ProcessTex::getSectionNameAndTitle(HatStream & fileIn, ostream & fileOut, string & sectionName, string & sectionTitle)
 {
 	string word;
 
 	fileIn >> word;
 	if(!(word == "*section-name*" || word == "*subsection-name*" || word == "*subsubsection-name*"))
 	{
-		cerr << "Incorrect word: "<<word<<"\n";
-		cerr << "A section name must follow the beginning of a section!\n";
+		*warningOut << "Incorrect word: "<<word<<"\n";
+		*warningOut << "A section name must follow the beginning of a section!\n";
 		//fileOut.close();
-		exit(1);
+		throw HatError();
 	};
 
 	sectionName = getText(fileIn);
@@ -346,10 +917,10 @@ void ProcessTex::getSectionNameAndTitle(ifstream & fileIn, ostream & fileOut, st
 	if(!(word == "*section-title*" || word == "*subsection-title*" || word == "*subsubsection-title*"
 		|| word == "*section-title-tex*" || word == "*subsection-title-tex*" || word == "*subsubsection-title-tex*"))
 	{
-		cerr << "Incorrect word: "<<word<<"\n";
-		cerr << "A section title must follow the section name!\n";
+		*warningOut << "Incorrect word: "<<word<<"\n";
+		*warningOut << "A section title must follow the section name!\n";
 		//fileOut.close();
-		exit(1);
+		throw HatError();
 	};
 
 	sectionTitle = getText(fileIn);
@@ -363,290 +934,66 @@ void ProcessTex::getSectionNameAndTitle(ifstream & fileIn, ostream & fileOut, st
 	};
 };
 
-void ProcessHat::getWebpageNameAndTitle(ifstream & fileIn, ostream & fileOut, string & webpageName, string & webpageTitle)
+void ProcessHat::getWebpageNameAndTitle(HatStream & fileIn, ostream & fileOut, string & webpageName, string & webpageTitle)
 {
 	string word;
 
 	fileIn >> word;
 	if(!(word == "*webpage-name*"))
 	{
-		cerr << "Incorrect word: "<<word<<"\n";
-		cerr << "A webpage name must follow the beginning of a webpage!\n";
+		*warningOut << "Incorrect word: "<<word<<"\n";
+		*warningOut << "A webpage name must follow the beginning of a webpage!\n";
 		//fileOut.close();
-		exit(1);
-	};
-
-	webpageName = getText(fileIn);
-	
-	fileIn >> word;
-	if(!(word == "*webpage-title*"))
-	{
-		cerr << "Incorrect word: "<<word<<"\n";
-		cerr << "A webpage title must follow the webpage name!\n";
-		//fileOut.close();
-		exit(1);
-	};
-
-	webpageTitle = getText(fileIn);
-
-};
-
-void ProcessHat::addWebpageData(string & filename, ostream & fileOut)
-{
-	ifstream fileWebpagesIn(filename.c_str());
-
-	if(!fileWebpagesIn.is_open())
-	{
-		cerr<<"Cannot read file: "<<filename<< "!?\n";
-		exit(1);
+		throw HatError();
 	};
 
-	string word, webpageName, webpageTitle;
-	Webpage * webpage;
-
-	fileWebpagesIn >> word;
-
-	do{
-
-		if(word == "*webpage*")
-		{
-			getWebpageNameAndTitle(fileWebpagesIn, fileOut, webpageName, webpageTitle);
-			
-			webpage = new Webpage(webpageName, webpageTitle);
-
-			orderedWebpages.push_back(webpage);
-		};
-
-		fileWebpagesIn >> word;
-
-	}while(!fileWebpagesIn.eof() && fileWebpagesIn.good());
-
-	fileWebpagesIn.close();
-};
-
-string getField(const string & fieldLine)
-{
-	unsigned int startPos = 0, endPos = 0;
-	unsigned int length = fieldLine.length();
-	unsigned int pos = 0;
-	bool pastEqualSign = false;
-
-	//find the start pos
-	do{
-		if(fieldLine.substr(pos, 1) == "=") pastEqualSign = true;
-		else if(pastEqualSign && fieldLine.substr(pos, 1) != " " && fieldLine.substr(pos, 1) != "{")
-		{
-//cout << pastEqualSign << " pastEqualSign--" << pos << " pos\n";
-			startPos = pos;
-			break;
-		};
-
-		pos++;
-	}while(pos < length);
-
-	pos = length - 2; //was length -1, the length was/is 1 too long? Will always be at least one unwanted char at end so - 2 is ok
-//cout << startPos << " " << pos << " --"<<fieldLine<<"\n";
-	//find the end pos
-	do{
-
-		if(fieldLine.substr(pos, 1) != " " && fieldLine.substr(pos, 1) != "}" && fieldLine.substr(pos, 1) != ",")
-		{
-			endPos = pos;
-			break;
-		};
-
-		pos--;
-	}while(pos >= 0);
-
-	return fieldLine.substr(startPos, (endPos-startPos+1));
-};
-
-void changeJournalName(Citation * citation)
-{
-
-	if(citation->journal == "ajhg") citation->journal = "Am J Hum Genet";
-	else if(citation->journal == "ajmg") citation->journal = "Am J  Med Genet";
-	else if(citation->journal == "ajmga") citation->journal = "Am J Med Genet A";
-	else if(citation->journal == "annals") citation->journal = "Ann Hum Genet";             
-	else if(citation->journal == "bmcs") citation->journal = "Biometrics";
-	else if(citation->journal == "bmka") citation->journal = "Biometrika";
-	else if(citation->journal == "ejhg") citation->journal = "Eur J  Hum Genet";
-	else if(citation->journal == "genepi") citation->journal = "Genet Epidemiol";
-	else if(citation->journal == "genom") citation->journal = "Genomics";
-	else if(citation->journal == "genet") citation->journal = "Genetics";
-	else if(citation->journal == "humgen") citation->journal = "Hum Genet";
-	else if(citation->journal == "humher") citation->journal = "Hum Hered";
-	else if(citation->journal == "hummol") citation->journal = "Hum Molec Genet";
-	else if(citation->journal == "jasa") citation->journal = "Journal of the American Statistical Association";
-	else if(citation->journal == "jci") citation->journal = "Journal of Clinical Immunity";
-	else if(citation->journal == "jrssb") citation->journal = "Journal of the Royal Statistical Society, Series B";
-	else if(citation->journal == "lancet") citation->journal = "Lancet";
-	else if(citation->journal == "natgenet") citation->journal = "Nat Genet";
-	else if(citation->journal == "nature") citation->journal = "Nature";
-	else if(citation->journal == "natrevgenet") citation->journal = "Nat Rev Genet";
-	else if(citation->journal == "science") citation->journal = "Science";
-	else if(citation->journal == "statmed") citation->journal = "Statistics in Medicine";
-	else if(citation->journal == "statsci") citation->journal = "Statistical Science";
-	else if(citation->journal == "TPB") citation->journal = "Theoretical Population Biology";
-	
-	if(citation->publisher == "Chapman \\& Hall/CRC") citation->publisher = "Chapman &amp; Hall/CRC";
-	else if(citation->publisher == "Chapman \\& Hall") citation->publisher = "Chapman &amp; Hall";
-	else if(citation->publisher == "Texts in Statistical Science, Chapman \\& Hall/CRC (US)") citation->publisher = "Texts in Statistical Science, Chapman &amp; Hall/CRC (US)";
-	else if(citation->publisher == "Chapman \\& Hall/CRC, London") citation->publisher = "Chapman &amp; Hall/CRC, London";
-	else if(citation->publisher == "John Wiley \\& Sons, New York") citation->publisher = "John Wiley &amp; Sons, New York";
-	
-
-};
-
-void changeAuthorsAndRefName(Citation * citation)
-{
-	string ans;
-	string refName = "";
-	string authors = citation->authors;
-	string orderName = "";
-
-	map<unsigned int, string> listAuthors;
-	unsigned int count = 1;
-	char commaChar = ',';
-
-	//cout << authors << "\n";
-	unsigned int pos = 0;
-	unsigned int lastPos = 0;
-
-	//get all authors of citation
-	do{		
-		if(authors.substr(pos, 5) == " and ")
-		{
-			listAuthors[count] = authors.substr(lastPos, (pos-lastPos + 1));
-			lastPos = pos + 5;
-			count++;
-		};
-			
-		pos++;		
-	}while(pos < (authors.length() - 5));
-
-	//add the last name
-	listAuthors[count] = authors.substr(lastPos);
-
-	string initials = "";
-	string aInitial;
-	string lastName = "";
-	unsigned int commaPos;
-	unsigned int lastSpacePos = 0;
-	unsigned int prevSpacePos = 0;
-
-	for(map<unsigned int, string>::const_iterator a = listAuthors.begin(); a != listAuthors.end(); ++a)
-	{
-		//cout << a->first << " " <<a->second <<"\n";
-		lastName = "";
-		initials = "";
-
-		//get the last name and initials
-		//check if there is a comma
-		pos = 0;
-		commaPos = 0;
-		do{
-			if(a->second.substr(pos, 1) == ",")
-			{
-				commaPos = pos;
-				break;
-			};			
-	
-			pos++;
-		}while(pos < a->second.length());
-
-		//if name has comma get last name and initials
-		if(commaPos != 0)
-		{
-			lastName = a->second.substr(0, commaPos);
-
-			pos = commaPos;
-			do{
-				if(a->second.substr(pos, 1) == " " && a->second.substr((pos + 1),1) != " " &&
-					(pos == (a->second.length() - 2) || a->second.substr((pos + 2), 1) == " "))
-				{
-					initials.append(a->second.substr((pos + 1),1));
-					initials.append(". ");
-				}
-				else if( //"J-B"					
-					a->second.substr(pos, 1) == " " && a->second.substr((pos + 1),1) != " " &&
-					a->second.length() - pos >= 3 && a->second.substr((pos + 2), 1) == "-" &&
-					(pos == (a->second.length() - 4) || a->second.substr((pos + 4), 1) == " ")					
-					)
-				{
-					initials.append(a->second.substr((pos + 1),3));
-					initials.append(". ");
-				};
-
-				pos++;
-			}while(pos <= (a->second.length() - 2));
-
-		}
-		else
-		{
+	webpageName = getText(fileIn);
+	
+	fileIn >> word;
+	if(!(word == "*webpage-title*"))
+	{
+		*warningOut << "Incorrect word: "<<word<<"\n";
+		*warningOut << "A webpage title must follow the webpage name!\n";
+		//fileOut.close();
+		throw HatError();
+	};
 
-			stringstream getNameAndInitials(a->second);
-			list<string> someStrings;
-			char space = ' ';
-			string aString;
+	webpageTitle = getText(fileIn);
 
-			//get initials and last name
-			do{
-				getline(getNameAndInitials, aString, space);
-				someStrings.push_back(aString);				
-			}while(!getNameAndInitials.eof() && getNameAndInitials.good());
+};
 
-			lastName = *(someStrings.rbegin());
+void ProcessHat::addWebpageData(string & filename, ostream & fileOut)
+{
+	HatStream fileWebpagesIn(getFile(filename));
 
-			for(list<string>::const_iterator ss = someStrings.begin(); ss != someStrings.end(); )
-			{
-				aString = *ss;
-				ss++;
-				if(ss != someStrings.end())
-				{
-					initials.append(aString);
-					if((aString).size() == 1) initials.append(". ");
-					else initials.append(" ");
-				};
+	if(!fileWebpagesIn.is_open())
+	{
+		*warningOut<<"Cannot read file: "<<filename<< "!?\n";
+		throw HatError();
+	};
 
-			};
+	HatWord word;
+	string webpageName, webpageTitle;
+	Webpage * webpage;
 
-		};
+	fileWebpagesIn >> word;
 
-		if(a->first == 1)
-		{
-			orderName.append(lastName);
-			orderName.append(citation->year);
-			refName.append(lastName);
-		};
+	do{
 
-		if(listAuthors.size() == 2 && a->first == 2)
+		if(word == "*webpage*")
 		{
-			string secondAuthor = " and " + lastName;
-			refName.append(secondAuthor);
-		};
+			getWebpageNameAndTitle(fileWebpagesIn, fileOut, webpageName, webpageTitle);
+			
+			webpage = new Webpage(webpageName, webpageTitle);
 
-		if(a->first >1 && a->first == listAuthors.size()) ans.append(" and ");
-		else if(a->first > 1)
-		{
-			if(ans.length() >= 1 && ans.substr(ans.length()-1, 1)==" ") ans = ans.substr(0, ans.length()-1);
-			ans.append(", ");
+			orderedWebpages.push_back(webpage);
 		};
 
-		ans.append(initials);
-		ans.append(lastName);
-	};
+		fileWebpagesIn >> word;
 
-	
-	if(listAuthors.size() > 2) refName.append(" et al.");
-	refName.append(" (");
-	refName.append(citation->year);
-	refName.append(")");
-	citation->refName = refName;
-	citation->orderName = orderName;
-	citation->authors = ans;
+	}while(!fileWebpagesIn.eof() && fileWebpagesIn.good());
 
-	if(citation->note != "") citation->refName = citation->authors;
+	fileWebpagesIn.close();
 };
 
 void ProcessHtml::addCitation(const string & citeName)
@@ -655,90 +1002,45 @@ void ProcessHtml::addCitation(const string & citeName)
 	map<string, Citation *>::const_iterator c = citations.find(citeName);
 	if(c != citations.end()) return;
 
-	Citation * citation = new Citation();
-	citation->name = citeName;
-	citations[citeName] = citation;
+	//the bib file is read the first time a citation is needed
+	HatPhaseTimer bibliographyTimer(stats, bibliographyPhase);
+	Bibliography * bibliography = document->getBibliography(bibFileName);
 
-	//open a new bib file
-	ifstream fileBibIn(bibFileName.c_str());
-	
-	if(!fileBibIn.is_open())
+	if(bibliography == 0)
 	{
-		cerr<<"Cannot read file: "<<bibFileName<< "!?\n";
-		exit(1);
+		*warningOut<<"Cannot read file: "<<bibFileName<< "!?\n";
+		throw HatError();
 	};
-	
-	string wordBib;
-	bool citeFound = false;
-	//find ref in file
-	do{
-		fileBibIn >> wordBib;	
-
-		if(((wordBib.length() >= (citeName.length() + 9)) && wordBib.substr(9, citeName.length()) == citeName)
-			|| (wordBib.length() >= (citeName.length() + 6)) && wordBib.substr(6, citeName.length()) == citeName)
-		{
-			citeFound = true;
-			break;
-		};
 
-	}while(!fileBibIn.eof() && fileBibIn.good());
+	Citation * citation = bibliography->getCitation(citeName);
+	bibliographyTimer.end();
+	if(stats != 0) stats->addCount(bibLookupCount, 1);
 
-	if(!citeFound)
+	if(citation == 0)
 	{
-		cerr << "Warning: citation "<< citeName <<" not found in file "<<bibFileName<<"!\n";
-		return;
-	};
-
-	string aLine;	
-	char returnChar = '\n';
-	set<string> citeLines;
-
-	//get all lines of citation
-	do{		
-		getline(fileBibIn, aLine, returnChar);
-		if(aLine.substr(0, 1) == "}") break;
-		citeLines.insert(aLine);
-	}while(!fileBibIn.eof() && fileBibIn.good());
+		*warningOut << "Warning: citation "<< citeName <<" not found in file "<<bibFileName<<"!\n";
 
-	//add fields of the citation
-	unsigned int length;
-	for(set<string>::const_iterator c = citeLines.begin(); c != citeLines.end(); ++c)
-	{
-		length = (*c).length();
-		if(length >= 6 && (c->substr(0, 6) == "author" || c->substr(0, 6) == "AUTHOR") ) citation->authors = getField(*c);
-		else if(length >= 5 && (c->substr(0, 5) == "title" || c->substr(0, 5) == "TITLE") ) citation->title = getField(*c);
-		else if(length >= 7 && (c->substr(0, 7) == "journal" || c->substr(0, 7) == "JOURNAL") ) citation->journal = getField(*c);
-		else if(length >= 6 && (c->substr(0, 6) == "volume" || c->substr(0, 6) == "VOLUME") ) citation->volume = getField(*c);
-		else if(length >= 6 && (c->substr(0, 6) == "number" || c->substr(0, 6) == "NUMBER") ) citation->number = getField(*c);
-		else if(length >= 4 && (c->substr(0, 4) == "year" || c->substr(0, 4) == "YEAR") ) citation->year = getField(*c);
-		else if(length >= 3 && (c->substr(0, 3) == "url" || c->substr(0, 3) == "URL") ) citation->url = getField(*c);
-		else if(length >= 5 && (c->substr(0, 5) == "pages" || c->substr(0, 5) == "PAGES") ) citation->pages = getField(*c);
-		else if(length >= 6 && (c->substr(0, 6) == "editor" || c->substr(0, 6) == "EDITOR") ) citation->editor = getField(*c);
-		else if(length >= 7 && (c->substr(0, 7) == "edition" || c->substr(0, 7) == "EDITION")) citation->edition = getField(*c);
-		else if(length >= 9 && (c->substr(0, 9) == "publisher" || c->substr(0, 9) == "PUBLISHER")) citation->publisher = getField(*c);
-		else if(length >= 4 && (c->substr(0, 4) == "note" || c->substr(0, 4) == "NOTE") ) citation->note = getField(*c);
+		//add an empty citation so that it is only warned about once
+		citation = new Citation();
+		citation->name = citeName;
+		missingCitations.push_back(citation);
 	};
 
-	changeJournalName(citation);
-	changeAuthorsAndRefName(citation);
-
-	fileBibIn.close();
+	citations[citeName] = citation;
 };
 
 void ProcessHtml::addReferences(string & filename, ostream & fileOut)
 {
-	ifstream fileCiteIn(filename.c_str());
+	HatStream fileCiteIn(getFile(filename));
 
 	if(!fileCiteIn.is_open())
 	{
-		cerr<<"Cannot read file: "<<filename<< "!?\n";
-		exit(1);
+		*warningOut<<"Cannot read file: "<<filename<< "!?\n";
+		throw HatError();
 	};
 
-	
-	string name, word;
-	
-	
+	HatWord word;
+	string name;
 
 	do{
 		fileCiteIn >> word;
@@ -754,11 +1056,11 @@ void ProcessHtml::addReferences(string & filename, ostream & fileOut)
 			
 			if(newFilename != "*/input*")
 			{
-				cerr<<"Input command not ended properly for file: "<<filename<< "!\n";
-				exit(1);
+				*warningOut<<"Input command not ended properly for file: "<<filename<< "!\n";
+				throw HatError();
 			};
 		}
-		else if(word.length() >= 6 && word.substr((word.length()-6), 6) == "*cite*")
+		else if(word.endsWith("*cite*"))
 		{
 			fileCiteIn >> name;				
 			addCitation(name);
@@ -772,15 +1074,15 @@ void ProcessHtml::addReferences(string & filename, ostream & fileOut)
 
 void ProcessHat::addTitleData(string & filename, ostream & fileOut)
 {
-	ifstream fileTitleIn(filename.c_str());
+	HatStream fileTitleIn(getFile(filename));
 
 	if(!fileTitleIn.is_open())
 	{
-		cerr<<"Cannot read file: "<<filename<< "!?\n";
-		exit(1);
+		*warningOut<<"Cannot read file: "<<filename<< "!?\n";
+		throw HatError();
 	};
 
-	string word;
+	HatWord word;
 	
 	fileTitleIn >> word;
 
@@ -833,15 +1135,16 @@ void ProcessHat::addTitleData(string & filename, ostream & fileOut)
 void ProcessHat::addSectionData(string & filename, ostream & fileOut, unsigned int & sectionCount, unsigned int & figureNo)
 {
 	unsigned int sectionDepth = 0;
-	ifstream fileSectionsIn(filename.c_str());
+	HatStream fileSectionsIn(getFile(filename));
 	
 	if(!fileSectionsIn.is_open())
 	{
-		cerr<<"Cannot read file: "<<filename<< "!?\n";
-		exit(1);
+		*warningOut<<"Cannot read file: "<<filename<< "!?\n";
+		throw HatError();
 	};
 
-	string word, sectionName, sectionNumber, sectionTitle;
+	HatWord word;
+	string sectionName, sectionNumber, sectionTitle;
 	bool newPageForSubsections;	
 	list<Section * > subsections;
 	Section * section;
@@ -861,8 +1164,8 @@ void ProcessHat::addSectionData(string & filename, ostream & fileOut, unsigned i
 			fileSectionsIn >> newFilename;
 			if(newFilename != "*/input*")
 			{
-				cerr<<"Input command not ended properly for file: "<<filename<< "!\n";
-				exit(1);
+				*warningOut<<"Input command not ended properly for file: "<<filename<< "!\n";
+				throw HatError();
 			};
 		}
 		else if(word == "*section*" || word == "*section2*")
@@ -870,11 +1173,15 @@ void ProcessHat::addSectionData(string & filename, ostream & fileOut, unsigned i
 			getSectionNameAndTitle(fileSectionsIn, fileOut, sectionName, sectionTitle);
 			sectionNumber = getSectionNumber(sectionUpperName, sectionCount, sectionDepth);
 			newPageForSubsections = (word == "*section2*");
+			unsigned int sourceStart = fileSectionsIn.getPosition();
 
 			//sectionStarts = 1; sectionEnds = 0;
 			subsections = getSubsections(sectionName, sectionNumber, fileSectionsIn, fileOut, newPageForSubsections, figureNo);
 
 			section = new Section(sectionNumber, sectionName, sectionTitle, subsections, sectionUpperName, newPageForSubsections);
+			section->sourceFile = fileSectionsIn.getFile();
+			section->sourceStart = sourceStart;
+			section->sourceEnd = fileSectionsIn.getPosition();
 
 			sections[sectionName] = section;
 			orderedSections.push_back(section);
@@ -900,13 +1207,14 @@ void ProcessHat::addSectionData(string & filename, ostream & fileOut, unsigned i
 	fileSectionsIn.close();
 };
 
-list<Section * > ProcessHat::getSubsections(string & sectionUpperName, string & sectionNumberUpper, ifstream & fileIn, ostream & fileOut, bool & newPageForSubsections, unsigned int & figureNo, unsigned int subsectionCount)
+list<Section * > ProcessHat::getSubsections(string & sectionUpperName, string & sectionNumberUpper, HatStream & fileIn, ostream & fileOut, bool & newPageForSubsections, unsigned int & figureNo, unsigned int subsectionCount)
 {
 	list<Section * > subsections, subsubsections, inputSubsections;
 	unsigned int sectionDepth = 1;//depth + 1;	
 	
 	
-	string word, sectionName, sectionTitle, sectionNumber;
+	HatWord word;
+	string sectionName, sectionTitle, sectionNumber;
 	string figRefName, figName;
 	Section * section;
 
@@ -924,8 +1232,8 @@ list<Section * > ProcessHat::getSubsections(string & sectionUpperName, string &
 			fileIn >> filename;
 			if(filename != "*/input*")
 			{
-				cerr<<"Input command not ended properly for file: "<<filename<< "!\n";
-				exit(1);
+				*warningOut<<"Input command not ended properly for file: "<<filename<< "!\n";
+				throw HatError();
 			};
 
 			//add input subsections to the list
@@ -973,12 +1281,13 @@ list<Section * > ProcessHat::getSubsections(string & sectionUpperName, string &
 	return subsections;
 };
 
-list<Section * > ProcessHat::getSubsubsections(string & sectionUpperUpperName, string & sectionNumberUpper, ifstream & fileIn, ostream & fileOut, unsigned int & figureNo, unsigned int subsubsectionCount)
+list<Section * > ProcessHat::getSubsubsections(string & sectionUpperUpperName, string & sectionNumberUpper, HatStream & fileIn, ostream & fileOut, unsigned int & figureNo, unsigned int subsubsectionCount)
 {
 	list<Section * > subsubsections, nosubs, inputSubsubsections;
 	unsigned int sectionDepth = 2;//depth + 1;	
 	
-	string word, sectionName, sectionTitle, sectionNumber;
+	HatWord word;
+	string sectionName, sectionTitle, sectionNumber;
 	string figRefName, figName;
 	Section * section;
 
@@ -996,8 +1305,8 @@ list<Section * > ProcessHat::getSubsubsections(string & sectionUpperUpperName, s
 			fileIn >> filename;
 			if(filename != "*/input*")
 			{
-				cerr<<"Input command not ended properly for file: "<<filename<< "!\n";
-				exit(1);
+				*warningOut<<"Input command not ended properly for file: "<<filename<< "!\n";
+				throw HatError();
 			};
 
 			//add input subsubsections to the list
@@ -1062,25 +1371,24 @@ string ProcessHat::getFigureNo(string & label)
 };
 
 //get all word up until the an end command, starts with */ 
-string ProcessHat::getText(ifstream & fileIn, string endWord)
+string ProcessHat::getText(HatStream & fileIn, string endWord)
 {
-	string word;
+	HatWord word;
 	string sentence = "";
 	bool atStart = true;
-	unsigned int length = endWord.length();
 	
 	do{
 
 		fileIn >> word;
 
-		if((endWord == "" && word.length() >= 2 && word.substr(0, 2) == "*/") ||
-			(endWord != "" && word.length() >= length && word.substr(0, length) == endWord)) return sentence;
+		if((endWord == "" && word.startsWith("*/")) ||
+			(endWord != "" && word.startsWith(endWord))) return sentence;
 		else if(!atStart)
 		{
 			sentence += " ";			
 		};
 
-		sentence += word;
+		sentence.append(word.start, word.length);
 		atStart = false;
 	}while(!fileIn.eof() && fileIn.good());
 
@@ -1088,9 +1396,9 @@ string ProcessHat::getText(ifstream & fileIn, string endWord)
 };
 
 //ignore all words up until the an end command, starts with */ 
-void ProcessHat::processComment(ifstream & fileIn)
+void ProcessHat::processComment(HatStream & fileIn)
 {
-	string word;
+	HatWord word;
 	
 	do{
 
@@ -1103,7 +1411,7 @@ void ProcessHat::processComment(ifstream & fileIn)
 	}while(!fileIn.eof() && fileIn.good());
 };
 
-void ProcessHat::processBoldTypeCommand(const string & starting, const string & ending, ifstream & fileIn, ostream & fileOut)
+void ProcessHat::processBoldTypeCommand(const string & starting, const string & ending, HatStream & fileIn, ostream & fileOut)
 {	
 	
 	string word;
@@ -1114,7 +1422,7 @@ void ProcessHat::processBoldTypeCommand(const string & starting, const string &
 
 		fileIn >> word;
 
-		if(word.length() >=2 && word.substr(0, 2) == "*/") break;
+		if(word.length() >=2 && word.compare(0, 2, "*/") == 0) break;
 		else if(!atStart)
 		{
 			sentence += " ";			
@@ -1132,17 +1440,35 @@ void ProcessHat::processBoldTypeCommand(const string & starting, const string &
 	processWord(word, fileIn, fileOut);
 };
 
-void ProcessHat::displayCreatedFiles()
+void ProcessHat::displayCreatedFiles(ostream & out)
 {
 
 	for(list<string>::const_iterator f = filesCreated.begin(); f != filesCreated.end(); ++f)
 	{
-		cout << "\t" << *f << "\n";
+		out << "\t" << *f << "\n";
 	};
 
+	if(noFilesUnchanged > 0) out << "\t(" << noFilesUnchanged << " of these files unchanged and not written again)\n";
+
+};
+
+//keep verbose output and warnings to display later, used when processing in a separate thread
+void ProcessHat::collectMessages()
+{
+	logOut = &collectedLog;
+	warningOut = &collectedWarnings;
+};
+
+void ProcessHat::displayMessages(ostream & out, ostream & err)
+{
+	out << collectedLog.str();
+	err << collectedWarnings.str();
+
+	collectedLog.str("");
+	collectedWarnings.str("");
 };
 
-void ProcessHat::displayNoSections()
+void ProcessHat::displayNoSections(ostream & out)
 {
 	unsigned int noSections = orderedSections.size();
 	unsigned int noSubsections = 0;
@@ -1151,36 +1477,40 @@ void ProcessHat::displayNoSections()
 		noSubsections += (*os)->subsections.size();
 	};
 
-	cout << "Number of sections: "<< noSections <<"\n";
-	cout << "Number of subsections: "<< noSubsections <<"\n";
+	out << "Number of sections: "<< noSections <<"\n";
+	out << "Number of subsections: "<< noSubsections <<"\n";
+};
+
+//the page of the first webpage in the menu, or of the first section if there are no webpages
+string ProcessHtml::getFirstPage()
+{
+	if(!orderedWebpages.empty()) return orderedWebpages.front()->name + ".html";
+	if(!orderedSections.empty()) return orderedSections.front()->name + ".html";
+
+	return "";
 };
 
-void ProcessHat::trimStartWord(string & word, ifstream & fileIn, ostream & fileOut)
+void ProcessHat::trimStartWord(string & word, HatStream & fileIn, ostream & fileOut)
 {
 	unsigned int length = word.length();
 	if(length < 3) return;
 
-	string startChars = "";
-	bool keyWordFoundAndTrim = false;
-
 	for(unsigned int i = 1; i <= length; ++i)
 	{
-		if(word.substr(i-1, 1) == "*" || word.substr(i-1, 1) == "$")
+		if(word[i-1] == '*' || word[i-1] == '$')
 		{
+			//write out the start chars and remove them from the word in place
 			if(i > 1)
 			{
-				keyWordFoundAndTrim = true;
-				startChars = word.substr(0, (i-1));
-				word = word.substr((i-1));
+				fileOut.write(word.data(), (i-1));
+				word.erase(0, (i-1));
 			};
 			break;
 		};
 	};
-
-	if(keyWordFoundAndTrim) fileOut << startChars;
 };
 
-string ProcessHat::trimEndWord(string & word, ifstream & fileIn, ostream & fileOut)
+string ProcessHat::trimEndWord(string & word, HatStream & fileIn, ostream & fileOut)
 {
 	unsigned int length = word.length();
 	if(length < 3) return "";
@@ -1189,12 +1519,12 @@ string ProcessHat::trimEndWord(string & word, ifstream & fileIn, ostream & fileO
 	
 	for(unsigned int i = length; i >= 1; --i)
 	{
-		if(word.substr(i-1, 1) == "*" || word.substr(i-1, 1) == "$")
+		if(word[i-1] == '*' || word[i-1] == '$')
 		{			
 			if(i < length)
 			{
-				endChars = word.substr(i);	
-				word = word.substr(0, i);													
+				endChars.assign(word, i, string::npos);
+				word.erase(i);
 			};
 			break;
 		};
@@ -1206,17 +1536,13 @@ string ProcessHat::trimEndWord(string & word, ifstream & fileIn, ostream & fileO
 //return ith char that is a $, 0 denote no $ found
 unsigned int getdollarPosition(string & word)
 {
-	unsigned int length = word.length();
-
-	for(unsigned int i = 1; i <= length; i++)
-	{
-		if(word.substr((i-1), 1) == "$") return i;
-	};
+	size_t pos = word.find('$');
 
-	return 0;
+	if(pos == string::npos) return 0;
+	else return pos + 1;
 };
 
-pair<string, string> ProcessHat::getLatexFormula(string & word, ifstream & fileIn, ostream & fileOut)
+pair<string, string> ProcessHat::getLatexFormula(string & word, HatStream & fileIn, ostream & fileOut)
 {
 	string formula = "";
 	string endChars = "";
@@ -1225,7 +1551,7 @@ pair<string, string> ProcessHat::getLatexFormula(string & word, ifstream & fileI
 	if(word == "$$") return make_pair(formula, endChars);
 
 	//remove dollar $ from the start of the string
-	if(word.length() > 1) word = word.substr(1);
+	if(word.length() > 1) word.erase(0, 1);
 
 	unsigned int dollarPos = getdollarPosition(word);
 
@@ -1320,23 +1646,14 @@ pair<string, string> ProcessHat::getLatexFormula(string & word, ifstream & fileI
 	return formula;*/
 };
 
-bool ProcessHat::nextWordIsEndWord(ifstream & fileIn)
+bool ProcessHat::nextWordIsEndWord(HatStream & fileIn)
 {
-	string nextWord;
-
-	//get position of next read
-	int pos = fileIn.tellg();
-
-	fileIn >> nextWord;
-
-	//put read position back to where it was
-	fileIn.seekg(pos);
-
-	return (nextWord.length() >= 2 && nextWord.substr(0,2) == "*/");
+	//the next word is already in memory so there is no need to read it and go back
+	return fileIn.nextWordStartsWith("*/");
 };
 
 
-string ProcessHat::getCodeExample(ifstream & fileIn, ostream & fileOut)
+string ProcessHat::getCodeExample(HatStream & fileIn, ostream & fileOut)
 {
 	string codeExample = "";
 	string codeExamplePiece;
@@ -1370,7 +1687,7 @@ string ProcessHat::getCodeExample(ifstream & fileIn, ostream & fileOut)
 	return codeExample.substr(1);
 };
 
-void ProcessHat::processTheSection(string & sectionName, string & sectionTitle, ifstream & fileIn, ostream & fileOut, unsigned int depth)
+void ProcessHat::processTheSection(string & sectionName, string & sectionTitle, HatStream & fileIn, ostream & fileOut, unsigned int depth)
 {
 	depth++;
 	//unsigned int sectionDepth = 0;
@@ -1381,15 +1698,15 @@ void ProcessHat::processTheSection(string & sectionName, string & sectionTitle,
 	map<string, Section * >::const_iterator s = sections.find(sectionName);
 	if(s == sections.end())
 	{
-		cerr << "Cannot find section: "<<sectionName<<"!\n";
+		*warningOut << "Cannot find section: "<<sectionName<<"!\n";
 
-		cerr << "\nHave sections:\n\n";
+		*warningOut << "\nHave sections:\n\n";
 		for(map<string, Section * >::const_iterator s = sections.begin(); s != sections.end(); ++s)
 		{
-			cerr << s->first << "\n";
+			*warningOut << s->first << "\n";
 		};
 		//fileOut.close();
-		exit(1);
+		throw HatError();
 	}
 	else
 	{
@@ -1409,21 +1726,21 @@ void ProcessHat::processTheSection(string & sectionName, string & sectionTitle,
 
 		//if word is a regular word (or bold, italic, underline, etc.) then start a paragraph
 		if(checkNextWordForPara && 
-			(!(word.length() >= 1 && word.substr(0, 1) == "*") ||
+			(!(word.length() >= 1 && word.compare(0, 1, "*") == 0) ||
 			  (word.length() >= 3 && 
-			    (word.substr(0, 3) == "*b*" || 
-				 word.substr(0, 3) == "*i*" ||
-				 word.substr(0, 3) == "*u*" ||
-				 word.substr(0, 3) == "*q*")) ||
+			    (word.compare(0, 3, "*b*") == 0 || 
+				 word.compare(0, 3, "*i*") == 0 ||
+				 word.compare(0, 3, "*u*") == 0 ||
+				 word.compare(0, 3, "*q*") == 0)) ||
 			  (word.length() >= 5 && 
-			    (word.substr(0, 5) == "*ref*" || 
-				 word.substr(0, 5) == "*tex*")) ||
+			    (word.compare(0, 5, "*ref*") == 0 || 
+				 word.compare(0, 5, "*tex*") == 0)) ||
 			  (word.length() >= 6 && 
-			    (word.substr(0, 6) == "*html*" || 
-				 word.substr(0, 6) == "*star*" ||
-				 word.substr(0, 6) == "*code*" ||
-				 word.substr(0, 6) == "*cite*" ||
-				 word.substr(0, 6) == "*perce"))
+			    (word.compare(0, 6, "*html*") == 0 || 
+				 word.compare(0, 6, "*star*") == 0 ||
+				 word.compare(0, 6, "*code*") == 0 ||
+				 word.compare(0, 6, "*cite*") == 0 ||
+				 word.compare(0, 6, "*perce") == 0))
 				 ))
 		{
 			//start of paragraph
@@ -1485,51 +1802,115 @@ void ProcessHat::processTheSection(string & sectionName, string & sectionTitle,
 
 };
 
-void ProcessTex::processSection(ifstream & fileIn, ostream & fileOut, unsigned int depth)
+void ProcessTex::processSection(HatStream & fileIn, ostream & fileOut, unsigned int depth)
 {
 	string sectionName, sectionTitle;
 
 	getSectionNameAndTitle(fileIn, fileOut, sectionName, sectionTitle);
 
-	if(verbose) cout << "\nStart TEX section: " << sectionName << " -- " << sectionTitle << " depth = " << depth << "\n";
-	processTheSection(sectionName, sectionTitle, fileIn, fileOut, depth);
-	if(verbose) cout << "\nEnd TEX section: " << sectionName << " -- " << sectionTitle << " depth = " << depth << "\n";
+	if(verbose) *logOut << "\nStart TEX section: " << sectionName << " -- " << sectionTitle << " depth = " << depth << "\n";
+
+	if(splitTex && depth == 0)
+	{
+		//each top level section is in its own file so that latex only processes the sections that have changed,
+		//files of sections that have not changed are left as they are
+		ostringstream sectionOut;
+		processTheSection(sectionName, sectionTitle, fileIn, sectionOut, depth);
+
+		string includeName = getIncludeName(sectionName);
+		sectionFileNames.push_back(includeName);
+		filesCreated.push_back(fileOutBase + "-" + sectionName + ".tex");
+		writeFile(filesCreated.back(), sectionOut.str());
+
+		fileOut << "\\include{" << includeName << "}\n";
+	}
+	else processTheSection(sectionName, sectionTitle, fileIn, fileOut, depth);
+
+	if(verbose) *logOut << "\nEnd TEX section: " << sectionName << " -- " << sectionTitle << " depth = " << depth << "\n";
 };
 
-void ProcessHtml::processSection(ifstream & fileIn, ostream & fileOut, unsigned int depth)
+void ProcessHtml::processSection(HatStream & fileIn, ostream & fileOut, unsigned int depth)
 {
 	string sectionName, sectionTitle;
 	getSectionNameAndTitle(fileIn, fileOut, sectionName, sectionTitle);
 
-	if(verbose) cout << "\nStart HTML section: " << sectionName << " -- " << sectionTitle << " depth = " << depth << "\n";
+	if(verbose) *logOut << "\nStart HTML section: " << sectionName << " -- " << sectionTitle << " depth = " << depth << "\n";
 
-	if(depth == 0 || (subSectionsOnNewPage && depth == 1) )
+	if(depth == 0 && (skipSectionPage(sectionName, fileIn) || addPageJob(sectionName, sectionTitle, fileIn)))
+	{
+		
+	}
+	else if(depth == 0 || (subSectionsOnNewPage && depth == 1) )
+	{
+		processSectionPage(sectionName, sectionTitle, fileIn, depth);
+	}
+	else
 	{
-		string newSectionNameFile = sectionName + ".html";
-		ofstream fileOutNewSection(newSectionNameFile.c_str());
+		processTheSection(sectionName, sectionTitle, fileIn, fileOut, depth);
+	};
+	if(verbose) *logOut << "\nEnd HTML section: " << sectionName << " -- " << sectionTitle << " depth = " << depth << "\n";
+};
+
+//writes a section on its own page
+void ProcessHtml::processSectionPage(string & sectionName, string & sectionTitle, HatStream & fileIn, unsigned int depth)
+{
+	//pages of whole sections are noted so they can be left alone in the next build if nothing on them changes
+	Section * section = 0;
+	if(depth == 0) section = getPageSection(sectionName, fileIn);
+
+	size_t noFilesCreatedBefore = filesCreated.size();
+	unsigned int noFilesNotWrittenBefore = noFilesNotWritten;
+	size_t noFilesReadBefore = filesRead.size();
+	ostream * pageWarningOut = warningOut;
+	ostringstream pageWarnings;
+	if(section != 0) warningOut = &pageWarnings;
+
+	string newSectionNameFile = sectionName + ".html";
+	HatPageStream fileOutNewSection(minify);
+
+	filesCreated.push_back(newSectionNameFile);
 
-		filesCreated.push_back(newSectionNameFile);
+	//a fatal error is shown after the warnings of the page
+	try
+	{
 		header(fileIn, fileOutNewSection); 
 		processTheSection(sectionName, sectionTitle, fileIn, fileOutNewSection, depth);
 		footer(fileIn, fileOutNewSection); 
-
-		fileOutNewSection.close();
 	}
-	else
+	catch(HatError &)
 	{
-		processTheSection(sectionName, sectionTitle, fileIn, fileOut, depth);
+		warningOut = pageWarningOut;
+		*warningOut << pageWarnings.str();
+		throw;
 	};
-	if(verbose) cout << "\nEnd HTML section: " << sectionName << " -- " << sectionTitle << " depth = " << depth << "\n";
+
+	writeFile(newSectionNameFile, fileOutNewSection.str());
+
+	if(section == 0) return;
+
+	warningOut = pageWarningOut;
+	*warningOut << pageWarnings.str();
+
+	if(fileIn.getPosition() != section->sourceEnd || noFilesNotWritten != noFilesNotWrittenBefore) return;
+
+	BuildRecord record;
+	record.key = getPageKey(section);
+	list<string>::iterator f = filesCreated.begin();
+	for(size_t i = 0; i < noFilesCreatedBefore; ++i) ++f;
+	record.filesCreated.assign(f, filesCreated.end());
+	record.warnings = pageWarnings.str();
+	getFilesRead(record, noFilesReadBefore);
+	document->addBuild("html " + sectionName, record);
 };
 
-void ProcessHtml::processWebpage(ifstream & fileIn, ostream & fileOut)
+void ProcessHtml::processWebpage(HatStream & fileIn, ostream & fileOut)
 {
 	processingWebpage = true;
 	string webpageName, webpageTitle;
 	getWebpageNameAndTitle(fileIn, fileOut, webpageName, webpageTitle);
 
 	string newWebpageNameFile = webpageName + ".html";
-	ofstream fileOutNewWebpage(newWebpageNameFile.c_str());
+	HatPageStream fileOutNewWebpage(minify);
 	
 	filesCreated.push_back(newWebpageNameFile);
 	header(fileIn, fileOutNewWebpage); 
@@ -1549,7 +1930,7 @@ void ProcessHtml::processWebpage(ifstream & fileIn, ostream & fileOut)
 		process = true;
 
 		//if word is a regular word then start a paragraph
-		if(checkNextWordForPara && !(word.length() >= 2 && word.substr(0, 1) == "*" && word.substr(0, 2) != "**"))
+		if(checkNextWordForPara && !(word.length() >= 2 && word.compare(0, 1, "*") == 0 && word.compare(0, 2, "**") != 0))
 		{
 			//start of paragraph
 			startParagraph(fileOutNewWebpage);
@@ -1589,16 +1970,16 @@ void ProcessHtml::processWebpage(ifstream & fileIn, ostream & fileOut)
 	fileOutNewWebpage << "</td>\n";
 	footer(fileIn, fileOutNewWebpage); 
 
-	fileOutNewWebpage.close();
+	writeFile(newWebpageNameFile, fileOutNewWebpage.str());
 	processingWebpage = false;
 };
 
-void ProcessHtml::addReferencesWebpage(ifstream & fileIn, ostream & fileOut)
+void ProcessHtml::addReferencesWebpage(HatStream & fileIn, ostream & fileOut)
 {
 	if(bibFileName == "") return;
 
 	string references = "references.html";
-	ofstream fileOutNewWebpage(references.c_str());
+	HatPageStream fileOutNewWebpage(minify);
 	filesCreated.push_back(references);
 
 	header(fileIn, fileOutNewWebpage); 
@@ -1635,7 +2016,7 @@ void ProcessHtml::addReferencesWebpage(ifstream & fileIn, ostream & fileOut)
 		if(oc->second->authors != "" && oc->second->editor != "") fileOutNewWebpage << "Edited by " << oc->second->editor <<".\n";
 		if(oc->second->note != "")
 		{
-			if((oc->second->note).length() >= 4 && oc->second->note.substr(0, 4) == "http") fileOutNewWebpage << "<a target=\"_blank\" href=\"" << oc->second->note << "\">"<< oc->second->note <<"</a> ";
+			if((oc->second->note).length() >= 4 && oc->second->note.compare(0, 4, "http") == 0) fileOutNewWebpage << "<a target=\"_blank\" href=\"" << oc->second->note << "\">"<< oc->second->note <<"</a> ";
 			else fileOutNewWebpage << oc->second->note << " ";
 		};
 		if(oc->second->journal != "") fileOutNewWebpage << "<i>" << oc->second->journal <<",</i> ";
@@ -1677,11 +2058,11 @@ void ProcessHtml::addReferencesWebpage(ifstream & fileIn, ostream & fileOut)
 	fileOutNewWebpage << "</td>\n";
 	footer(fileIn, fileOutNewWebpage); 
 
-	fileOutNewWebpage.close();
+	writeFile(references, fileOutNewWebpage.str());
 
 };
 
-void ProcessTex::processHtml(ifstream & fileIn, ostream & fileOut)
+void ProcessTex::processHtml(HatStream & fileIn, ostream & fileOut)
 {
 	//do nothing with text
 	string word;
@@ -1702,7 +2083,7 @@ void ProcessTex::processHtml(ifstream & fileIn, ostream & fileOut)
 	}while(!fileIn.eof() && fileIn.good());
 };
 
-void ProcessTex::processWebpage(ifstream & fileIn, ostream & fileOut)
+void ProcessTex::processWebpage(HatStream & fileIn, ostream & fileOut)
 {
 	string word;
 	fileIn >> word;
@@ -1714,7 +2095,7 @@ void ProcessTex::processWebpage(ifstream & fileIn, ostream & fileOut)
 
 };
 
-void ProcessTex::processTex(ifstream & fileIn, ostream & fileOut)
+void ProcessTex::processTex(HatStream & fileIn, ostream & fileOut)
 {
 	string word;
 	fileIn >> word;
@@ -1738,7 +2119,7 @@ void ProcessTex::processTex(ifstream & fileIn, ostream & fileOut)
 
 };
 
-void ProcessHtml::processHtml(ifstream & fileIn, ostream & fileOut)
+void ProcessHtml::processHtml(HatStream & fileIn, ostream & fileOut)
 {
 	string word;
 	fileIn >> word;
@@ -1761,7 +2142,7 @@ void ProcessHtml::processHtml(ifstream & fileIn, ostream & fileOut)
 	}while(!fileIn.eof() && fileIn.good());
 };
 
-void ProcessHtml::processTex(ifstream & fileIn, ostream & fileOut)
+void ProcessHtml::processTex(HatStream & fileIn, ostream & fileOut)
 {
 	
 	//do nothing with text
@@ -1835,10 +2216,9 @@ void ProcessHtml::startSection(ostream & fileOut, Section * section, unsigned in
 	};
 };
 
-void ProcessHtml::addNextAndPrev(ostream & fileOut, Section * section)
+//finds the page before and after each section page, the pages are the sections and the subsections of sections with subsections on new pages
+void ProcessHtml::addPageOrder()
 {
-	Section * prev = 0;
-
 	list<Section *> orderedSectionsAndSubsections;
 
 	for(list<Section * >::const_iterator os = orderedSections.begin(); os != orderedSections.end(); ++os)
@@ -1854,43 +2234,56 @@ void ProcessHtml::addNextAndPrev(ostream & fileOut, Section * section)
 		};
 	};
 
+	Section * prev = 0;
+	Section * next;
+	map<string, Section * >::const_iterator s;
+
 	for(list<Section *>::const_iterator i = orderedSectionsAndSubsections.begin(); i != orderedSectionsAndSubsections.end(); )
 	{
-		if((*i)->name == section->name)
-		{
-			fileOut << "<br />\n<div class=\"prevnext\">";
-			
-			if(prev != 0)
-			{		
-				fileOut << "<span class=\"left\">";
-				if(prev->nameUpperSection != "") fileOut << "<a href=\""<<prev->nameUpperSection<<".html#"<<prev->name<<"\"><-prev</a>\n";
-				else fileOut << "<a href=\""<<prev->name<<".html\">&lt;-prev</a>\n";		
-				fileOut << "</span>";
-			};
-
-			prev = *i;
-			i++;
+		s = sections.find((*i)->name);
+		Section * section = *i;
+		i++;
 
-			if(i != orderedSectionsAndSubsections.end())
-			{	
-				fileOut << "<span class=\"right\">";
-				if((*i)->nameUpperSection != "") fileOut << "<a href=\""<<(*i)->nameUpperSection<<".html#"<<(*i)->name<<"\">next-></a>\n";
-				else fileOut << "<a href=\""<<(*i)->name<<".html\">next-&gt;</a>\n";		
-				fileOut << "</span>";
-			};
+		if(i != orderedSectionsAndSubsections.end()) next = *i; else next = 0;
 
-			fileOut << "</div>";
-			return;
-		}
-		else
+		//sections are found by name when written, so a repeated name gets the links of its first page
+		if(s != sections.end() && !s->second->hasPageOrder)
 		{
-			prev = *i;
-			i++;
+			s->second->hasPageOrder = true;
+			s->second->prevPage = prev;
+			s->second->nextPage = next;
 		};
-	
+
+		prev = section;
+	};
+};
+
+void ProcessHtml::addNextAndPrev(ostream & fileOut, Section * section)
+{
+	if(!section->hasPageOrder) return;
+
+	Section * prev = section->prevPage;
+	Section * next = section->nextPage;
+
+	fileOut << "<br />\n<div class=\"prevnext\">";
+
+	if(prev != 0)
+	{		
+		fileOut << "<span class=\"left\">";
+		if(prev->nameUpperSection != "") fileOut << "<a href=\""<<prev->nameUpperSection<<".html#"<<prev->name<<"\"><-prev</a>\n";
+		else fileOut << "<a href=\""<<prev->name<<".html\">&lt;-prev</a>\n";		
+		fileOut << "</span>";
 	};
 
+	if(next != 0)
+	{	
+		fileOut << "<span class=\"right\">";
+		if(next->nameUpperSection != "") fileOut << "<a href=\""<<next->nameUpperSection<<".html#"<<next->name<<"\">next-></a>\n";
+		else fileOut << "<a href=\""<<next->name<<".html\">next-&gt;</a>\n";		
+		fileOut << "</span>";
+	};
 
+	fileOut << "</div>";
 };
 
 void ProcessHtml::endSection(ostream & fileOut, Section * section, unsigned int & depth)
@@ -1921,8 +2314,144 @@ void ProcessHtml::endParagraph(ostream & fileOut)
 	fileOut << "</p>\n";
 };
 
-void ProcessHtml::header(ifstream & fileIn, ostream & fileOut)
+//writes a page to search the whole document along with an index of the words on each page for it to use
+void ProcessHtml::addSearchWebpage(string & filename, HatStream & fileIn)
+{
+	if(verbose) *logOut << "Adding search index\n";
+
+	HatSearch hatSearch;
+	vector<string> targetLinks;
+	addSearchWords(filename, hatSearch, targetLinks);
+
+	map<string, string> searchFiles;
+	hatSearch.getFiles(searchFiles);
+
+	for(map<string, string>::const_iterator f = searchFiles.begin(); f != searchFiles.end(); ++f)
+	{
+		filesCreated.push_back(f->first);
+		writeFile(f->first, f->second);
+	};
+
+	string searchPage = "search.html";
+	HatPageStream fileOutNewWebpage(minify);
+	filesCreated.push_back(searchPage);
+
+	header(fileIn, fileOutNewWebpage);
+
+	fileOutNewWebpage << "<td valign=\"top\">\n";
+	fileOutNewWebpage << "<!-- Begin Right Column -->\n";
+	fileOutNewWebpage << "<div id=\"rightcolumn\">\n";
+
+	fileOutNewWebpage << "<h1>Search</h1>\n";
+	fileOutNewWebpage << "<form action=\"search.html\" onsubmit=\"hatSearch.search(); return false;\">\n"
+					  << "<p><input type=\"text\" id=\"searchtext\" size=\"40\" onkeyup=\"hatSearch.search();\" /></p>\n"
+					  << "</form>\n";
+	fileOutNewWebpage << "<div id=\"searchresults\"></div>\n";
+	fileOutNewWebpage << "<script type=\"text/javascript\" src=\"search/search.js\"></script>\n";
+
+	fileOutNewWebpage << "</div>\n";
+	fileOutNewWebpage << "<!-- End Right Column -->\n";
+	fileOutNewWebpage << "</td>\n";
+	footer(fileIn, fileOutNewWebpage);
+
+	writeFile(searchPage, fileOutNewWebpage.str());
+};
+
+//adds the words of a source file to the search index for the page or section they are on, following input files,
+//words that are not shown on the pages such as section names, comments, raw html and tex are left out
+void ProcessHtml::addSearchWords(const string & filename, HatSearch & hatSearch, vector<string> & targetLinks)
+{
+	HatStream fileIn(getFile(filename));
+	if(!fileIn.is_open()) return;
+
+	HatWord word;
+	string name, title, link;
+
+	fileIn >> word;
+
+	do{
+		if(word == "*input*")
+		{
+			string inputFilename;
+			fileIn >> inputFilename;
+
+			addSearchWords(inputFilename, hatSearch, targetLinks);
+
+			fileIn >> word;
+		}
+		else if(word == "*webpage*" || word == "*section*" || word == "*section2*" || word == "*subsection*" || word == "*subsubsection*")
+		{
+			bool isWebpage = (word == "*webpage*");
+			bool isSection = (word == "*section*" || word == "*section2*");
+			bool isSubsection = (word == "*subsection*");
+
+			fileIn >> word;
+			name = getText(fileIn);
+			title = name;
+
+			if(isWebpage)
+			{
+				link = name + ".html";
+
+				for(list<Webpage * >::const_iterator ow = orderedWebpages.begin(); ow != orderedWebpages.end(); ++ow)
+				{
+					if((*ow)->name == name) title = (*ow)->title;
+				};
+			}
+			else
+			{
+				//a section is on its own page or at an anchor on the page of the section it is in, as in the contents
+				map<string, Section * >::const_iterator s = sections.find(name);
+				if(s != sections.end())
+				{
+					if(s->second->number != "") title = s->second->number + " " + s->second->title;
+					else title = s->second->title;
+				};
+
+				if(isSection || targetLinks.empty() || (isSubsection && s != sections.end() && s->second->nameUpperSection == "")) link = name + ".html";
+				else link = targetLinks.back().substr(0, targetLinks.back().find('#')) + "#" + name;
+			};
+
+			targetLinks.push_back(link);
+			hatSearch.setTarget(link, title);
+		}
+		else if(word == "*/webpage*" || word == "*/section*" || word == "*/subsection*" || word == "*/subsubsection*")
+		{
+			if(!targetLinks.empty()) targetLinks.pop_back();
+
+			if(targetLinks.empty()) hatSearch.clearTarget();
+			else hatSearch.setTarget(targetLinks.back(), "");
+		}
+		else if(word == "*comment*" || word == "*html*" || word == "*tex*" || word == "*cite*" || word == "*ref*" || word == "*figref*"
+			|| word == "*label*" || word == "*width*" || word == "*widthtex*" || word.endsWith("-title-tex*"))
+		{
+			getText(fileIn);
+		}
+		else if(word == "*figure*")
+		{
+			//the image file
+			fileIn >> word;
+		}
+		else if(!(word.length >= 3 && word.start[0] == '*' && word.start[word.length - 1] == '*' && memchr(word.start + 1, '*', word.length - 2) == 0))
+		{
+			hatSearch.addText(word.start, word.length);
+		};
+
+		fileIn >> word;
+
+	}while(!fileIn.eof() && fileIn.good());
+};
+
+void ProcessHtml::header(HatStream & fileIn, ostream & fileOut)
+{
+	fileOut << headerText;
+};
+
+//makes the header once the title, sections and webpages are known, it is then the same for every page
+void ProcessHtml::addHeaderText(HatStream & fileIn)
 {
+	ostringstream fileOut;
+
 	fileOut << "<!DOCTYPE html PUBLIC \"-//W3C//DTD XHTML 1.0 Strict//EN\" \"http://www.w3.org/TR/xhtml1/DTD/xhtml1-strict.dtd\">\n"
 			<< "<html xmlns=\"http://www.w3.org/1999/xhtml\">\n"
 			<< "<head>\n"
@@ -1968,9 +2497,11 @@ void ProcessHtml::header(ifstream & fileIn, ostream & fileOut)
 	contents(fileIn, fileOut);
 
 	fileOut << "</td>\n";
+
+	headerText = fileOut.str();
 };
 
-void ProcessHtml::menu(ifstream & fileIn, ostream & fileOut)
+void ProcessHtml::menu(HatStream & fileIn, ostream & fileOut)
 {
 
 	fileOut << "<!-- Begin Menu Navigation -->\n"
@@ -1991,15 +2522,40 @@ void ProcessHtml::menu(ifstream & fileIn, ostream & fileOut)
 
 };
 
-void ProcessHtml::contents(ifstream & fileIn, ostream & fileOut)
+void ProcessHtml::contents(HatStream & fileIn, ostream & fileOut)
 {
 	
     fileOut << "<!-- Begin Left Column -->\n"
 		   << "<div id=\"leftcolumn\">\n";
 
-    fileOut << "<!-- Begin Contents Navigation -->\n"
-			<< "<div id=\"navcontainer\">\n"
-			<< "<ul>\n";
+	//the shared contents are put in the empty container by a script, which can be cached along with the script
+	if(sharedNavigation)
+	{
+		fileOut << "<!-- Begin Contents Navigation -->\n"
+				<< "<div id=\"navcontainer\"></div>\n"
+				<< "<script type=\"text/javascript\" src=\"contents.js\"></script>\n"
+				<< "<noscript><p><a href=\"contents.html\">Contents</a></p></noscript>\n"
+				<< "<!-- End Contents Navigation -->\n";
+	}
+	else
+	{
+		fileOut << "<!-- Begin Contents Navigation -->\n"
+				<< "<div id=\"navcontainer\">\n";
+
+		contentsList(fileOut);
+
+		fileOut << "</div>\n"
+				<< "<!-- End Contents Navigation -->\n";
+	};
+
+	fileOut << "</div>\n"
+			<< "<!-- End Left Column -->\n";
+		
+};
+
+void ProcessHtml::contentsList(ostream & fileOut)
+{
+	fileOut << "<ul>\n";
 
 	for(list<Section * >::iterator os = orderedSections.begin(); os != orderedSections.end(); ++os)
 	{
@@ -2019,26 +2575,61 @@ void ProcessHtml::contents(ifstream & fileIn, ostream & fileOut)
 	};
 
 	if(bibFileName != "") fileOut << "<li><a href=\"references.html\">References</a></li>\n";
+	if(search) fileOut << "<li><a href=\"search.html\">Search</a></li>\n";
 
 	fileOut << "</ul>\n";
+};
 
-	fileOut << "</div>\n"
-			<< "<!-- End Contents Navigation -->\n";
+//writes the contents once for every page to load, as a script and as a page for browsers without scripts
+void ProcessHtml::addContentsFiles(HatStream & fileIn)
+{
+	if(!sharedNavigation) return;
 
-	fileOut << "</div>\n"
-			<< "<!-- End Left Column -->\n";
-		
+	HatPageStream contentsOut(minify);
+	contentsList(contentsOut);
+
+	string script = "document.getElementById(\"navcontainer\").innerHTML = ";
+	appendScriptString(script, contentsOut.str());
+	script += ";\n";
+
+	string contentsScript = "contents.js";
+	filesCreated.push_back(contentsScript);
+	writeFile(contentsScript, script);
+
+	string contentsPage = "contents.html";
+	HatPageStream fileOutNewWebpage(minify);
+	filesCreated.push_back(contentsPage);
+
+	header(fileIn, fileOutNewWebpage);
+
+	fileOutNewWebpage << "<td valign=\"top\">\n";
+	fileOutNewWebpage << "<!-- Begin Right Column -->\n";
+	fileOutNewWebpage << "<div id=\"rightcolumn\">\n";
+
+	fileOutNewWebpage << "<h1>Contents</h1>\n";
+	contentsList(fileOutNewWebpage);
+
+	fileOutNewWebpage << "</div>\n";
+	fileOutNewWebpage << "<!-- End Right Column -->\n";
+	fileOutNewWebpage << "</td>\n";
+	footer(fileIn, fileOutNewWebpage);
+
+	writeFile(contentsPage, fileOutNewWebpage.str());
 };
 
-void ProcessHtml::addFooterText(ostream & fileOut)
+//reads the footer file once, it is then the same for every page
+void ProcessHtml::addFooterText()
 {
-	ifstream fileFooterIn(footerFileName.c_str());
+	if(footerFileName == "") return;
+
+	HatStream fileFooterIn(getFile(footerFileName));
+	ostringstream fileOut;
 	string word;
 
 	if(!fileFooterIn.is_open())
 	{
-		cerr<<"Cannot read file: "<<footerFileName<< "!\n";
-		exit(1);
+		*warningOut<<"Cannot read file: "<<footerFileName<< "!\n";
+		throw HatError();
 	};
 
 	do{
@@ -2049,22 +2640,24 @@ void ProcessHtml::addFooterText(ostream & fileOut)
 
 	}while(!fileFooterIn.eof() && fileFooterIn.good());
 
+	footerText = fileOut.str();
+
 };
 
-void ProcessHtml::footer(ifstream & fileIn, ostream & fileOut)
+void ProcessHtml::footer(HatStream & fileIn, ostream & fileOut)
 {
 	fileOut << "</tr></table>\n";
 	fileOut << "<!-- End Wrapper -->\n"
 			<< "</td></tr></table>\n"
 			<< "</div>\n";
 
-	if(footerFileName != "") addFooterText(fileOut);
+	fileOut << footerText;
 
 	fileOut << "</body>\n"
 			<< "</html>\n";
 };
 
-void ProcessTex::header(ifstream & fileIn, ostream & fileOut)
+void ProcessTex::header(HatStream & fileIn, ostream & fileOut)
 {
 	fileOut << "\\documentclass[a4paper,12pt]{article}\n"
 			<< "\\setcounter{secnumdepth}{2}\n"
@@ -2086,6 +2679,9 @@ void ProcessTex::header(ifstream & fileIn, ostream & fileOut)
 			<< "\\addtolength{\\textheight}{2cm} % c = -d, where this is c and d is below\n"
 			<< "\\addtolength{\\voffset}{-2cm}\n";
 
+	//the sections to typeset may be chosen in the includeonly file, which is only written if it is not there already
+	if(splitTex) fileOut << "\\InputIfFileExists{" << getIncludeName("includeonly") << "}{}{}\n";
+
 	fileOut	<< "\\begin{document}\n";
 
 	if(subtitle != "")	fileOut << "\\title{"<<title<<" {\\small "<<subtitle<<"}}\n";
@@ -2128,7 +2724,7 @@ void ProcessTex::header(ifstream & fileIn, ostream & fileOut)
 
 };
 
-void ProcessTex::footer(ifstream & fileIn, ostream & fileOut)
+void ProcessTex::footer(HatStream & fileIn, ostream & fileOut)
 {
 	if(bibFileName != "")
 	{
@@ -2138,9 +2734,39 @@ void ProcessTex::footer(ifstream & fileIn, ostream & fileOut)
 	};
 
 	fileOut << "\\end{document}";
+
+	if(splitTex) addIncludeOnlyFile();
+};
+
+//writes a file with the section files commented out in an \includeonly, to be edited to typeset only some of the sections,
+//it is not written again once it is there so that the sections chosen are kept
+void ProcessTex::addIncludeOnlyFile()
+{
+	string includeOnlyFileName = fileOutBase + "-includeonly.tex";
+	filesCreated.push_back(includeOnlyFileName);
+
+	if(output->hasFile(includeOnlyFileName))
+	{
+		noFilesUnchanged++;
+		return;
+	};
+
+	string includeOnly = "% uncomment the line below and remove any sections not wanted to typeset only some of the sections,\n"
+		"% the others keep their page and section numbers from the last time latex was run on all of them\n"
+		"%\\includeonly{";
+
+	for(list<string>::const_iterator s = sectionFileNames.begin(); s != sectionFileNames.end(); ++s)
+	{
+		if(s != sectionFileNames.begin()) includeOnly += ",";
+		includeOnly += *s;
+	};
+
+	includeOnly += "}\n";
+
+	writeFile(includeOnlyFileName, includeOnly);
 };
 
-void ProcessTex::processCode(ifstream & fileIn, ostream & fileOut, bool start)
+void ProcessTex::processCode(HatStream & fileIn, ostream & fileOut, bool start)
 {
 	if(start) fileOut << "\\code{";
 	else fileOut << "}";
@@ -2158,7 +2784,7 @@ void ProcessTex::processCode(ifstream & fileIn, ostream & fileOut, bool start)
 	//fileOut << "}";
 };
 
-void ProcessHtml::processCode(ifstream & fileIn, ostream & fileOut, bool start)
+void ProcessHtml::processCode(HatStream & fileIn, ostream & fileOut, bool start)
 {
 	if(start) processBoldTypeCommand("<tt>", "</tt>", fileIn, fileOut);
 
@@ -2181,7 +2807,7 @@ void ProcessHtml::processCode(ifstream & fileIn, ostream & fileOut, bool start)
 	//fileOut << "</tt>";
 };
 
-void ProcessTex::processCodeExample(ifstream & fileIn, ostream & fileOut)
+void ProcessTex::processCodeExample(HatStream & fileIn, ostream & fileOut)
 {
 	//string word;
 	//fileIn >> word;
@@ -2208,7 +2834,7 @@ void ProcessTex::processCodeExample(ifstream & fileIn, ostream & fileOut)
 	fileOut << "\\end{lstlisting} \\vspace{0.35cm}";
 };
 
-void ProcessHtml::processCodeExample(ifstream & fileIn, ostream & fileOut)
+void ProcessHtml::processCodeExample(HatStream & fileIn, ostream & fileOut)
 {
 	string codeExample = getCodeExample(fileIn, fileOut);
 	replaceSpecialChars(codeExample);
@@ -2227,7 +2853,7 @@ void ProcessHtml::processCodeExample(ifstream & fileIn, ostream & fileOut)
 	//fileOut << "</pre>\n";
 };
 
-void ProcessTex::processCodeExampleSmall(ifstream & fileIn, ostream & fileOut)
+void ProcessTex::processCodeExampleSmall(HatStream & fileIn, ostream & fileOut)
 {
 	//string word;
 	//fileIn >> word;
@@ -2253,7 +2879,7 @@ void ProcessTex::processCodeExampleSmall(ifstream & fileIn, ostream & fileOut)
 	fileOut << "\\end{lstlisting}}\n";
 };
 
-void ProcessHtml::processCodeExampleSmall(ifstream & fileIn, ostream & fileOut)
+void ProcessHtml::processCodeExampleSmall(HatStream & fileIn, ostream & fileOut)
 {
 	string codeExample = getCodeExample(fileIn, fileOut);
 	replaceSpecialChars(codeExample);
@@ -2288,7 +2914,7 @@ void ProcessHtml::replaceSpecialChars(string & aString)
 };
 
 //align 1 = right, 2 = left, 3 = center
-void ProcessHtml::processTable(ifstream & fileIn, ostream & fileOut, const unsigned int & align, const bool & scale)
+void ProcessHtml::processTable(HatStream & fileIn, ostream & fileOut, const unsigned int & align, const bool & scale)
 {
 	bool firstRow = true;
 	string word;
@@ -2333,7 +2959,7 @@ void ProcessHtml::processTable(ifstream & fileIn, ostream & fileOut, const unsig
 	fileOut << "</table>\n";
 };
 
-void ProcessHtml::processFigure(ifstream & fileIn, ostream & fileOut)
+void ProcessHtml::processFigure(HatStream & fileIn, ostream & fileOut)
 {
 	string fig, word;
 	string caption = "";
@@ -2349,9 +2975,9 @@ void ProcessHtml::processFigure(ifstream & fileIn, ostream & fileOut)
 	//next word should be start of caption 
 	fileIn >> word;	
 
-	if(!(word.length() >= 9 && word.substr(0, 9) == "*caption*"))
+	if(!(word.length() >= 9 && word.compare(0, 9, "*caption*") == 0))
 	{
-			cerr << "Found "<< word <<" instead of *caption* for figure "<<fig<<"!\n"; 
+			*warningOut << "Found "<< word <<" instead of *caption* for figure "<<fig<<"!\n"; 
 	}
 	else
 	{
@@ -2359,9 +2985,9 @@ void ProcessHtml::processFigure(ifstream & fileIn, ostream & fileOut)
 			//next word should be start of label 
 			fileIn >> word;	
 
-			if(!(word.length() >= 7 && word.substr(0, 7) == "*label*"))
+			if(!(word.length() >= 7 && word.compare(0, 7, "*label*") == 0))
 			{
-				cerr << "Found "<< word <<" instead of *label* for figure "<<fig<<"!\n";
+				*warningOut << "Found "<< word <<" instead of *label* for figure "<<fig<<"!\n";
 				figName = "Figure ?. "; 
 			}
 			else
@@ -2376,7 +3002,7 @@ void ProcessHtml::processFigure(ifstream & fileIn, ostream & fileOut)
 
 	fileIn >> word;	
 
-	if(word.length() >= 7 && word.substr(0, 7) == "*width*")
+	if(word.length() >= 7 && word.compare(0, 7, "*width*") == 0)
 	{
 		width = getText(fileIn);
 		fileIn >> word;	
@@ -2388,19 +3014,19 @@ void ProcessHtml::processFigure(ifstream & fileIn, ostream & fileOut)
 			<< figName << caption <<"\n"
 			<< "</div>\n";
 	
-	if(word.length() >= 10 && word.substr(0, 10) == "*widthtex*")
+	if(word.length() >= 10 && word.compare(0, 10, "*widthtex*") == 0)
 	{
 		widthtex = getText(fileIn); 
 		fileIn >> word;	
 	};
 	
 
-	if(!(word.length() >= 9 && word.substr(0, 9) == "*/figure*")) cerr << "Warning */figure* not found at end of figure: "<<fig<<"!\n"; 
+	if(!(word.length() >= 9 && word.compare(0, 9, "*/figure*") == 0)) *warningOut << "Warning */figure* not found at end of figure: "<<fig<<"!\n"; 
 	
 };
 
 //align 1 = right, 2 = left, 3 = center
-void ProcessTex::processTable(ifstream & fileIn, ostream & fileOut, const unsigned int & align, const bool & scale)
+void ProcessTex::processTable(HatStream & fileIn, ostream & fileOut, const unsigned int & align, const bool & scale)
 {
 	bool firstRow = true;
 	string word;
@@ -2467,7 +3093,7 @@ void ProcessTex::processTable(ifstream & fileIn, ostream & fileOut, const unsign
 	fileOut << all;
 };
 
-void ProcessTex::processFigure(ifstream & fileIn, ostream & fileOut)
+void ProcessTex::processFigure(HatStream & fileIn, ostream & fileOut)
 {
 	string fig, word;
 	string caption = "";
@@ -2483,9 +3109,9 @@ void ProcessTex::processFigure(ifstream & fileIn, ostream & fileOut)
 	//next word should be start of caption 
 	fileIn >> word;	
 
-	if(!(word.length() >= 9 && word.substr(0, 9) == "*caption*"))
+	if(!(word.length() >= 9 && word.compare(0, 9, "*caption*") == 0))
 	{
-			cerr << "Warning caption not found for figure "<<fig<<"!\n"; 
+			*warningOut << "Warning caption not found for figure "<<fig<<"!\n"; 
 	}
 	else
 	{
@@ -2493,9 +3119,9 @@ void ProcessTex::processFigure(ifstream & fileIn, ostream & fileOut)
 			//next word should be start of label 
 			fileIn >> word;	
 
-			if(!(word.length() >= 7 && word.substr(0, 7) == "*label*"))
+			if(!(word.length() >= 7 && word.compare(0, 7, "*label*") == 0))
 			{
-				cerr << "Warning label not found for figure "<<fig<<"!\n";
+				*warningOut << "Warning label not found for figure "<<fig<<"!\n";
 				label = ""; 
 			}
 			else
@@ -2508,13 +3134,13 @@ void ProcessTex::processFigure(ifstream & fileIn, ostream & fileOut)
 
 	fileIn >> word;	
 
-	if(word.length() >= 7 && word.substr(0, 7) == "*width*")
+	if(word.length() >= 7 && word.compare(0, 7, "*width*") == 0)
 	{
 		width = getText(fileIn);
 		fileIn >> word;	
 	};
 
-	if(word.length() >= 10 && word.substr(0, 10) == "*widthtex*")
+	if(word.length() >= 10 && word.compare(0, 10, "*widthtex*") == 0)
 	{
 		width = getText(fileIn); 
 		fileIn >> word;	
@@ -2535,11 +3161,11 @@ void ProcessTex::processFigure(ifstream & fileIn, ostream & fileOut)
 			<< "}\n";
 
 
-	if(!(word.length() >= 9 && word.substr(0, 9) == "*/figure*")) cerr << "Warning */figure* not found at end of figure: "<<fig<<"!\n"; 
+	if(!(word.length() >= 9 && word.compare(0, 9, "*/figure*") == 0)) *warningOut << "Warning */figure* not found at end of figure: "<<fig<<"!\n"; 
 	
 };
 
-void ProcessTex::processList(ifstream & fileIn, ostream & fileOut, const bool & numList)
+void ProcessTex::processList(HatStream & fileIn, ostream & fileOut, const bool & numList)
 {	
 	string word;
 
@@ -2560,7 +3186,7 @@ void ProcessTex::processList(ifstream & fileIn, ostream & fileOut, const bool &
 
 };
 
-void ProcessHtml::processList(ifstream & fileIn, ostream & fileOut, const bool & numList)
+void ProcessHtml::processList(HatStream & fileIn, ostream & fileOut, const bool & numList)
 {
 	bool atStart = true;
 	string word;
@@ -2587,7 +3213,7 @@ void ProcessHtml::processList(ifstream & fileIn, ostream & fileOut, const bool &
 	else fileOut << "</li>\n</ul>\n";
 };
 
-void ProcessTex::processRef(ifstream & fileIn, ostream & fileOut)
+void ProcessTex::processRef(HatStream & fileIn, ostream & fileOut)
 {
 	string word;
 	
@@ -2596,12 +3222,12 @@ void ProcessTex::processRef(ifstream & fileIn, ostream & fileOut)
 	fileOut << " section \\ref{"<<word<<"}";
 
 	fileIn >> word;
-	if(word.length() >= 7 && word.substr(0, 6) == "*/ref*") fileOut << word.substr(6)<<" "; 
-	else if(!(word.length() >= 6 && word.substr(0, 6) == "*/ref*")) cerr << "Warning */ref* not found at end of reference!\n"; 
+	if(word.length() >= 7 && word.compare(0, 6, "*/ref*") == 0) fileOut << word.substr(6)<<" "; 
+	else if(!(word.length() >= 6 && word.compare(0, 6, "*/ref*") == 0)) *warningOut << "Warning */ref* not found at end of reference!\n"; 
 	else fileOut << " ";
 };
 
-void ProcessTex::processFigRef(ifstream & fileIn, ostream & fileOut)
+void ProcessTex::processFigRef(HatStream & fileIn, ostream & fileOut)
 {
 	string word;
 	
@@ -2610,12 +3236,12 @@ void ProcessTex::processFigRef(ifstream & fileIn, ostream & fileOut)
 	fileOut << " \\ref{"<<word<<"}";
 
 	fileIn >> word;
-	if(word.length() >= 10 && word.substr(0, 9) == "*/figref*") fileOut << word.substr(9)<<" "; 
-	else if(!(word.length() >= 9 && word.substr(0, 9) == "*/figref*")) cerr << "Warning */figref* not found at end of figure reference!\n"; 
+	if(word.length() >= 10 && word.compare(0, 9, "*/figref*") == 0) fileOut << word.substr(9)<<" "; 
+	else if(!(word.length() >= 9 && word.compare(0, 9, "*/figref*") == 0)) *warningOut << "Warning */figref* not found at end of figure reference!\n"; 
 	else fileOut << " ";
 };
 
-void ProcessHtml::processRef(ifstream & fileIn, ostream & fileOut)
+void ProcessHtml::processRef(HatStream & fileIn, ostream & fileOut)
 {
 	string word;
 	fileIn >> word;
@@ -2632,7 +3258,7 @@ void ProcessHtml::processRef(ifstream & fileIn, ostream & fileOut)
 	}
 	else
 	{
-		cerr << "Warning reference: "<<word<<" not found!\n"; 
+		*warningOut << "Warning reference: "<<word<<" not found!\n"; 
 		fileIn >> word;
 		
 		fileOut <<"section ?";
@@ -2640,12 +3266,12 @@ void ProcessHtml::processRef(ifstream & fileIn, ostream & fileOut)
 				
 	};
 
-	if(word.length() >= 7 && word.substr(0, 6) == "*/ref*") fileOut << word.substr(6) <<" "; 
-	else if(!(word.length() >= 6 && word.substr(0, 6) == "*/ref*")) cerr << "Warning */ref* not found at end of reference: "<<s->second->name<<"!\n"; 
+	if(word.length() >= 7 && word.compare(0, 6, "*/ref*") == 0) fileOut << word.substr(6) <<" "; 
+	else if(!(word.length() >= 6 && word.compare(0, 6, "*/ref*") == 0)) *warningOut << "Warning */ref* not found at end of reference: "<<s->second->name<<"!\n"; 
 	else fileOut << " ";
 };
 
-void ProcessHtml::processFigRef(ifstream & fileIn, ostream & fileOut)
+void ProcessHtml::processFigRef(HatStream & fileIn, ostream & fileOut)
 {
 	string word, ref;
 	fileIn >> word;
@@ -2659,7 +3285,7 @@ void ProcessHtml::processFigRef(ifstream & fileIn, ostream & fileOut)
 	}
 	else
 	{
-		cerr << "Warning figure reference: "<<word<<" not found!\n"; 		
+		*warningOut << "Warning figure reference: "<<word<<" not found!\n"; 		
 		
 		ref = "?";			
 	};
@@ -2668,12 +3294,12 @@ void ProcessHtml::processFigRef(ifstream & fileIn, ostream & fileOut)
 
 	fileIn >> word;
 
-	if(word.length() >= 10 && word.substr(0, 9) == "*/figref*") fileOut << word.substr(9) <<" "; 
-	else if(!(word.length() >= 9 && word.substr(0, 9) == "*/figref*")) cerr << "Warning */figref* not found at end of figure reference: "<<ref<<"!\n"; 
+	if(word.length() >= 10 && word.compare(0, 9, "*/figref*") == 0) fileOut << word.substr(9) <<" "; 
+	else if(!(word.length() >= 9 && word.compare(0, 9, "*/figref*") == 0)) *warningOut << "Warning */figref* not found at end of figure reference: "<<ref<<"!\n"; 
 	else fileOut << " ";
 };
 
-void ProcessHtml::processBold(string & word, ifstream & fileIn, ostream & fileOut, bool start)
+void ProcessHtml::processBold(string & word, HatStream & fileIn, ostream & fileOut, bool start)
 {
 	//if(start) processBoldTypeCommand("<b>", "</b>", fileIn, fileOut);
 	if(start) fileOut << "<b>";
@@ -2685,7 +3311,7 @@ void ProcessHtml::processBold(string & word, ifstream & fileIn, ostream & fileOu
 	};*/
 };
 
-void ProcessHtml::processItalic(string & word, ifstream & fileIn, ostream & fileOut, bool start)
+void ProcessHtml::processItalic(string & word, HatStream & fileIn, ostream & fileOut, bool start)
 {
 	//if(start) processBoldTypeCommand("<i>", "</i>", fileIn, fileOut);
 	if(start) fileOut << "<i>";
@@ -2697,7 +3323,7 @@ void ProcessHtml::processItalic(string & word, ifstream & fileIn, ostream & file
 	};*/
 };
 
-void ProcessHtml::processUnderline(string & word, ifstream & fileIn, ostream & fileOut, bool start)
+void ProcessHtml::processUnderline(string & word, HatStream & fileIn, ostream & fileOut, bool start)
 {
 	//if(start) processBoldTypeCommand("<u>", "</u>", fileIn, fileOut);
 	if(start) fileOut << "<u>";
@@ -2710,7 +3336,7 @@ void ProcessHtml::processUnderline(string & word, ifstream & fileIn, ostream & f
 	};*/
 };
 
-void ProcessTex::processBold(string & word, ifstream & fileIn, ostream & fileOut, bool start)
+void ProcessTex::processBold(string & word, HatStream & fileIn, ostream & fileOut, bool start)
 {
 	//if(start) processBoldTypeCommand("{\\bf ", "}", fileIn, fileOut);
 	if(start) fileOut << "{\\bf ";
@@ -2722,7 +3348,7 @@ void ProcessTex::processBold(string & word, ifstream & fileIn, ostream & fileOut
 	};*/
 };
 
-void ProcessTex::processItalic(string & word, ifstream & fileIn, ostream & fileOut, bool start)
+void ProcessTex::processItalic(string & word, HatStream & fileIn, ostream & fileOut, bool start)
 {
 	//if(start) processBoldTypeCommand("{\\it ", "}", fileIn, fileOut);
 	if(start) fileOut << "{\\it ";
@@ -2734,7 +3360,7 @@ void ProcessTex::processItalic(string & word, ifstream & fileIn, ostream & fileO
 	};*/
 };
 
-void ProcessTex::processUnderline(string & word, ifstream & fileIn, ostream & fileOut, bool start)
+void ProcessTex::processUnderline(string & word, HatStream & fileIn, ostream & fileOut, bool start)
 {
 	//if(start) processBoldTypeCommand("\\underline{", "}", fileIn, fileOut);
 	if(start) fileOut << "\\underline{";
@@ -2747,38 +3373,38 @@ void ProcessTex::processUnderline(string & word, ifstream & fileIn, ostream & fi
 	};*/
 };
 
-void ProcessTex::processQuote(ifstream & fileIn, ostream & fileOut, bool start)
+void ProcessTex::processQuote(HatStream & fileIn, ostream & fileOut, bool start)
 {
 	//if(start) processBoldTypeCommand("``", "''", fileIn, fileOut);
 	if(start) fileOut << "``";
 	else fileOut << "''";
 };
 
-void ProcessHtml::processQuote(ifstream & fileIn, ostream & fileOut, bool start)
+void ProcessHtml::processQuote(HatStream & fileIn, ostream & fileOut, bool start)
 {
 	//if(start) processBoldTypeCommand("&ldquo;", "&rdquo;", fileIn, fileOut);
 	if(start) fileOut << "&ldquo;";
 	else fileOut << "&rdquo;";
 };
 
-void ProcessHtml::processQuoteOneWord(string & word, ifstream & fileIn, ostream & fileOut)
+void ProcessHtml::processQuoteOneWord(string & word, HatStream & fileIn, ostream & fileOut)
 {
 	fileOut << "&ldquo;"<<word.substr(3, (word.length()-7))<<"&rdquo;";		
 };
 
-void ProcessTex::processQuoteOneWord(string & word, ifstream & fileIn, ostream & fileOut)
+void ProcessTex::processQuoteOneWord(string & word, HatStream & fileIn, ostream & fileOut)
 {
 	fileOut << "``"<<word.substr(3, (word.length()-7))<<"''";		
 };
 
-void ProcessTex::processLatexFormula(string & word, ifstream & fileIn, ostream & fileOut)
+void ProcessTex::processLatexFormula(string & word, HatStream & fileIn, ostream & fileOut)
 {
 	//string formula = getLatexFormula(word, fileIn, fileOut);
 
 	fileOut << "$" << word << "$";
 };
 
-void ProcessHtml::processLatexFormula(string & word, ifstream & fileIn, ostream & fileOut)
+void ProcessHtml::processLatexFormula(string & word, HatStream & fileIn, ostream & fileOut)
 {
 	//string formula = getLatexFormula(word, fileIn, fileOut);
 
@@ -2788,17 +3414,17 @@ void ProcessHtml::processLatexFormula(string & word, ifstream & fileIn, ostream
 	//fileOut << "<img src=\"http://latex.codecogs.com/png.latex?"<<word<<"\">";		
 };
 
-void ProcessHtml::processPercent(ifstream & fileIn, ostream & fileOut)
+void ProcessHtml::processPercent(HatStream & fileIn, ostream & fileOut)
 {
 	fileOut << "%";
 };
 
-void ProcessTex::processPercent(ifstream & fileIn, ostream & fileOut)
+void ProcessTex::processPercent(HatStream & fileIn, ostream & fileOut)
 {
 	fileOut << "\\%";
 };
 
-void ProcessTex::processCite(ifstream & fileIn, ostream & fileOut, bool start)
+void ProcessTex::processCite(HatStream & fileIn, ostream & fileOut, bool start)
 {
 	
 	if(start)
@@ -2812,7 +3438,7 @@ void ProcessTex::processCite(ifstream & fileIn, ostream & fileOut, bool start)
 
 };
 
-void ProcessHtml::processCite(ifstream & fileIn, ostream & fileOut, bool start)
+void ProcessHtml::processCite(HatStream & fileIn, ostream & fileOut, bool start)
 {
 
 	if(start)
@@ -2827,7 +3453,7 @@ void ProcessHtml::processCite(ifstream & fileIn, ostream & fileOut, bool start)
 		else
 		{
 			ref = word;
-			cerr << "Warning: citation "<<word<<" not found!\n";
+			*warningOut << "Warning: citation "<<word<<" not found!\n";
 		};
 
 		fileOut << "<a href=\"references.html#"<<word<<"\">"<<ref<<"</a>";
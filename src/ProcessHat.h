@@ -12,6 +12,29 @@
 #include <map>
 #include <iostream>
 #include <fstream>
+#include <sstream>
+#include <vector>
+#include <mutex>
+
+#include "HatDocument.h"
+#include "HatOutput.h"
+#include "HatStats.h"
+#include "HatSearch.h"
+#include "HatPageStream.h"
+
+//the commands that processWord acts on, the title commands are all ignored like a comment
+enum HatCommand {notCommand, sectionCommand, section2Command, webpageCommand, commentCommand, htmlCommand, texCommand,
+	codeExampleCommand, codeExampleSmallCommand, listCommand, numListCommand,
+	tableCommand, tablerCommand, tablelCommand, tablecCommand, tableroptCommand, tableloptCommand, tablecoptCommand,
+	refCommand, figRefCommand, figureCommand, starCommand, dollarCommand, codeCommand, codeEndCommand,
+	boldCommand, boldEndCommand, italicCommand, italicEndCommand, underlineCommand, underlineEndCommand,
+	quoteCommand, quoteEndCommand, citeCommand, citeEndCommand, percentCommand, inputCommand};
+
+//thrown once a fatal error in a document has been displayed, so that other documents of a batch can carry on
+struct HatError
+{
+
+};
 
 //basic class for storing webpage info
 struct Webpage
@@ -27,32 +50,6 @@ struct Webpage
 	};
 };
 
-//basic class for storing info about a section
-struct Citation
-{
-	string name;
-	string title;
-	string authors;
-	string year;	
-	string journal;
-	string volume;
-	string number;
-	string pages;
-	string url;
-	string editor;
-	string edition;
-	string publisher;
-	string refName;
-	string orderName;
-	string note;
-
-	~Citation()
-	{
-		
-	};
-
-};
-
 //basic class for storing info about a section
 struct Section
 {
@@ -62,8 +59,15 @@ struct Section
 	list<Section * > subsections;
 	string nameUpperSection;
 	bool newPageForSubsections;
+	HatFile * sourceFile; //where the section is in the source, from after the title to after the end of the section
+	unsigned int sourceStart;
+	unsigned int sourceEnd;
+	bool hasPageOrder; //whether the section is a page with links to the previous and next pages
+	Section * prevPage;
+	Section * nextPage;
 	
-	Section(string nu, string na, string t, list<Section * > ss, string nus, bool np) : number(nu), name(na), title(t), subsections(ss), nameUpperSection(nus), newPageForSubsections(np) {};
+	Section(string nu, string na, string t, list<Section * > ss, string nus, bool np) : number(nu), name(na), title(t), subsections(ss), nameUpperSection(nus), newPageForSubsections(np), sourceFile(0), sourceStart(0), sourceEnd(0),
+		hasPageOrder(false), prevPage(0), nextPage(0) {};
 
 	~Section()
 	{
@@ -81,10 +85,17 @@ private:
 	
 protected:
 
+	HatDocument * document; //source files, shared with other processing of the same document
+	HatOutput * output; //where the output files are written
+	unsigned int noFilesUnchanged; //files not written as they are the same as before
+	unsigned int noFilesNotWritten; //files that could not be written
+	HatStats * stats; //times and counts, if wanted
+	int gzipLevel; //of the compressed copies of pages and scripts, 0 for none
 	map<string, Section * > sections; //name, details
 	list<Section * > orderedSections; //section in order
 	map<string, string> figures; //figure ref name, figure name 
 	list<string> filesCreated;
+	list<string> filesRead; //source files read, to find what each output depends on
 	list<Webpage * > orderedWebpages;
 	string title;
 	string subtitle;
@@ -100,13 +111,25 @@ protected:
 	bool processingWebpage;
 	string texFileName;
 	bool verbose;
+	ostream * logOut; //verbose output, cout unless collected
+	ostream * warningOut; //warnings, cerr unless collected
+	ostringstream collectedLog;
+	ostringstream collectedWarnings;
+	bool ownsSections; //false for a copy used to write pages in another thread
+
+	ProcessHat(const ProcessHat & master) : document(master.document), output(master.output), noFilesUnchanged(0), noFilesNotWritten(0), stats(master.stats), gzipLevel(master.gzipLevel), sections(master.sections), orderedSections(master.orderedSections), figures(master.figures), filesCreated(), filesRead(), orderedWebpages(master.orderedWebpages),
+		title(master.title), subtitle(master.subtitle), date(master.date), author(master.author), address(master.address), abstract(master.abstract), styleFile(master.styleFile), logo(master.logo), logowidth(master.logowidth),
+		subSectionsOnNewPage(master.subSectionsOnNewPage), bibFileName(master.bibFileName), processingWebpage(master.processingWebpage), texFileName(master.texFileName), verbose(master.verbose),
+		logOut(&collectedLog), warningOut(&collectedWarnings), collectedLog(), collectedWarnings(), ownsSections(false) {};
 
 public:
 
-	ProcessHat(string & bfn, string tfn = "") : sections(), orderedSections(), figures(), filesCreated(), title(""), subtitle(""), author(""), address(""), styleFile("styles.css"), logo(""), logowidth(0), subSectionsOnNewPage(false), bibFileName(bfn), processingWebpage(false), texFileName(tfn) {};
+	ProcessHat(HatDocument * doc, HatOutput * out, string & bfn, string tfn = "") : document(doc), output(out), noFilesUnchanged(0), noFilesNotWritten(0), stats(0), gzipLevel(0), sections(), orderedSections(), figures(), filesCreated(), filesRead(), title(""), subtitle(""), author(""), address(""), styleFile("styles.css"), logo(""), logowidth(0), subSectionsOnNewPage(false), bibFileName(bfn), processingWebpage(false), texFileName(tfn), logOut(&cout), warningOut(&cerr), collectedLog(), collectedWarnings(), ownsSections(true) {};
 
 	virtual ~ProcessHat()
 	{
+		if(!ownsSections) return;
+
 		for(list<Section *>::iterator i = orderedSections.begin(); i != orderedSections.end(); ++i)
 		{			
 			delete *i;
@@ -115,168 +138,240 @@ public:
 
 
 	virtual void process(string & filename);
-	virtual void processWord(string & word, ifstream & fileIn, ostream & fileOut);
-	void processFile(ifstream & fileIn, ofstream & fileOut);
-	void processInputFile(ifstream & fileIn, ostream & fileOut);
-	void processInput(ifstream & fileIn, ostream & fileOut);	
-	virtual void getSectionNameAndTitle(ifstream & fileIn, ostream & fileOut, string & sectionName, string & sectionTitle) {};
-	void getWebpageNameAndTitle(ifstream & fileIn, ostream & fileOut, string & webpageName, string & webpageTitle);
+	virtual void addBuildKey(string & keyText) {};
+	HatFile * getFile(const string & filename);
+	void getFilesRead(BuildRecord & record, size_t noFilesBefore);
+	unsigned long long getBytesRead(size_t noFilesBefore);
+	unsigned long long getNoWordsRead();
+	void setStats(HatStats * st) {stats = st;};
+	void setGzipLevel(const int & level) {gzipLevel = level;};
+	virtual void processWord(string & word, HatStream & fileIn, ostream & fileOut);
+	void processFile(HatStream & fileIn, ostream & fileOut);
+	void writeFile(const string & fileName, const string & text);
+	void writeGzipFile(const string & fileName, const string & text);
+	void processInputFile(HatStream & fileIn, ostream & fileOut);
+	void processInput(HatStream & fileIn, ostream & fileOut);	
+	virtual void getSectionNameAndTitle(HatStream & fileIn, ostream & fileOut, string & sectionName, string & sectionTitle) {};
+	void getWebpageNameAndTitle(HatStream & fileIn, ostream & fileOut, string & webpageName, string & webpageTitle);
 	void addSectionData(string & filename, ostream & fileOut, unsigned int & sectionCount, unsigned int & figureNo);
 	void addWebpageData(string & filename, ostream & fileOut);
 	void addTitleData(string & filename, ostream & fileOut);
-	list<Section * > getSubsections(string & sectionUpperName, string & sectionNumberUpper, ifstream & fileIn, ostream & fileOut, bool & newPageForSubsections, unsigned int & figureNo, unsigned int subsectionCount = 1);
-	list<Section * > getSubsubsections(string & sectionUpperUpperName, string & sectionNumberUpper, ifstream & fileIn, ostream & fileOut, unsigned int & figureNo, unsigned int subsubsectionCount = 1);
+	list<Section * > getSubsections(string & sectionUpperName, string & sectionNumberUpper, HatStream & fileIn, ostream & fileOut, bool & newPageForSubsections, unsigned int & figureNo, unsigned int subsectionCount = 1);
+	list<Section * > getSubsubsections(string & sectionUpperUpperName, string & sectionNumberUpper, HatStream & fileIn, ostream & fileOut, unsigned int & figureNo, unsigned int subsubsectionCount = 1);
 	string getSectionNumber(string & sectionNumber, unsigned int & sectionCount, unsigned int & sectionDepth);
 	string getFigureNo(string & label);
-	string getText(ifstream & fileIn, string endWord = "");
-	void processComment(ifstream & fileIn);		
-	void processBoldTypeCommand(const string & starting, const string & ending, ifstream & fileIn, ostream & fileOut);
-	void processTheSection(string & sectionName, string & sectionTitle, ifstream & fileIn, ostream & fileOut, unsigned int depth);
-	void displayCreatedFiles();
-	void displayNoSections();
-	void trimStartWord(string & word, ifstream & fileIn, ostream & fileOut);
-	string trimEndWord(string & word, ifstream & fileIn, ostream & fileOut);
-	pair<string, string> getLatexFormula(string & word, ifstream & fileIn, ostream & fileOut);
-	string getCodeExample(ifstream & fileIn, ostream & fileOut);
-	bool nextWordIsEndWord(ifstream & fileIn);
-
-	virtual void processSection(ifstream & fileIn, ostream & fileOut, unsigned int depth) {};
-	virtual void processWebpage(ifstream & fileIn, ostream & fileOut) {};
+	string getText(HatStream & fileIn, string endWord = "");
+	void processComment(HatStream & fileIn);		
+	void processBoldTypeCommand(const string & starting, const string & ending, HatStream & fileIn, ostream & fileOut);
+	void processTheSection(string & sectionName, string & sectionTitle, HatStream & fileIn, ostream & fileOut, unsigned int depth);
+	void displayCreatedFiles(ostream & out);
+	void collectMessages();
+	void displayMessages(ostream & out, ostream & err);
+	void displayNoSections(ostream & out);
+	void trimStartWord(string & word, HatStream & fileIn, ostream & fileOut);
+	string trimEndWord(string & word, HatStream & fileIn, ostream & fileOut);
+	pair<string, string> getLatexFormula(string & word, HatStream & fileIn, ostream & fileOut);
+	string getCodeExample(HatStream & fileIn, ostream & fileOut);
+	bool nextWordIsEndWord(HatStream & fileIn);
+
+	virtual void processSection(HatStream & fileIn, ostream & fileOut, unsigned int depth) {};
+	virtual void processWebpage(HatStream & fileIn, ostream & fileOut) {};
 	virtual void startSection(ostream & fileOut, Section * section, unsigned int & depth) {};
 	virtual void endSection(ostream & fileOut, Section * section, unsigned int & depth) {};
 	virtual void startParagraph(ostream & fileOut) {};
 	virtual void endParagraph(ostream & fileOut) {};
 	virtual string getFileOutName(string & filename) {return "";};
-	virtual void processHtml(ifstream & fileIn, ostream & fileOut) {};
-	virtual void processTex(ifstream & fileIn, ostream & fileOut) {};
-	virtual void processCode(ifstream & fileIn, ostream & fileOut, bool start) {};
-	virtual void processBold(string & word, ifstream & fileIn, ostream & fileOut, bool start) {};
-	virtual void processItalic(string & word, ifstream & fileIn, ostream & fileOut, bool start) {};
-	virtual void processUnderline(string & word, ifstream & fileIn, ostream & fileOut, bool start) {};
-	virtual void header(ifstream & fileIn, ostream & fileOut) {};
-	virtual void footer(ifstream & fileIn, ostream & fileOut) {};
-	virtual void menu(ifstream & fileIn, ostream & fileOut) {};
-	virtual void contents(ifstream & fileIn, ostream & fileOut) {};	
-	virtual void processCodeExample(ifstream & fileIn, ostream & fileOut) {};
-	virtual void processCodeExampleSmall(ifstream & fileIn, ostream & fileOut) {};
-	virtual void processTable(ifstream & fileIn, ostream & fileOut, const unsigned int & align = 1, const bool & scale = false) {};
-	virtual void processFigure(ifstream & fileIn, ostream & fileOut) {};
-	virtual void processList(ifstream & fileIn, ostream & fileOut, const bool & numList) {};
-	virtual void processRef(ifstream & fileIn, ostream & fileOut) {};
-	virtual void processFigRef(ifstream & fileIn, ostream & fileOut) {};
-	virtual void processLatexFormula(string & word, ifstream & fileIn, ostream & fileOut) {};
-	virtual void processQuote(ifstream & fileIn, ostream & fileOut, bool start) {};
-	virtual void processQuoteOneWord(string & word, ifstream & fileIn, ostream & fileOut) {};
-	virtual void processPercent(ifstream & fileIn, ostream & fileOut) {};
-	virtual void processCite(ifstream & fileIn, ostream & fileOut, bool start) {};
+	virtual void processHtml(HatStream & fileIn, ostream & fileOut) {};
+	virtual void processTex(HatStream & fileIn, ostream & fileOut) {};
+	virtual void processCode(HatStream & fileIn, ostream & fileOut, bool start) {};
+	virtual void processBold(string & word, HatStream & fileIn, ostream & fileOut, bool start) {};
+	virtual void processItalic(string & word, HatStream & fileIn, ostream & fileOut, bool start) {};
+	virtual void processUnderline(string & word, HatStream & fileIn, ostream & fileOut, bool start) {};
+	virtual void header(HatStream & fileIn, ostream & fileOut) {};
+	virtual void footer(HatStream & fileIn, ostream & fileOut) {};
+	virtual void menu(HatStream & fileIn, ostream & fileOut) {};
+	virtual void contents(HatStream & fileIn, ostream & fileOut) {};	
+	virtual void processCodeExample(HatStream & fileIn, ostream & fileOut) {};
+	virtual void processCodeExampleSmall(HatStream & fileIn, ostream & fileOut) {};
+	virtual void processTable(HatStream & fileIn, ostream & fileOut, const unsigned int & align = 1, const bool & scale = false) {};
+	virtual void processFigure(HatStream & fileIn, ostream & fileOut) {};
+	virtual void processList(HatStream & fileIn, ostream & fileOut, const bool & numList) {};
+	virtual void processRef(HatStream & fileIn, ostream & fileOut) {};
+	virtual void processFigRef(HatStream & fileIn, ostream & fileOut) {};
+	virtual void processLatexFormula(string & word, HatStream & fileIn, ostream & fileOut) {};
+	virtual void processQuote(HatStream & fileIn, ostream & fileOut, bool start) {};
+	virtual void processQuoteOneWord(string & word, HatStream & fileIn, ostream & fileOut) {};
+	virtual void processPercent(HatStream & fileIn, ostream & fileOut) {};
+	virtual void processCite(HatStream & fileIn, ostream & fileOut, bool start) {};
 	virtual void replaceSpecialChars(string & aString) {};
 };
 
+struct PageJob;
+
 //a class for producing the html files
 class ProcessHtml : public ProcessHat
 {
 private:
 	
-	map<string, Citation *> citations;
+	map<string, Citation *> citations; //cited entries of the bibliography
+	list<Citation *> missingCitations; //cited entries not in the bib file
 	string footerFileName;
+	unsigned int noThreads;
+	vector<PageJob *> pageJobs; //section pages to write in other threads
+	string headerText; //the header, menu and contents, the same on every page
+	string footerText; //the text of the footer file
+	unsigned long long navigationKey; //hash of everything on a section page which is not in the section
+	bool search; //write a search index and page
+	bool minify; //write pages without comments and extra white space
+	bool sharedNavigation; //the contents are in a file loaded by every page rather than on every page
+
+	ProcessHtml(const ProcessHtml & master) : ProcessHat(master), citations(master.citations), missingCitations(), footerFileName(master.footerFileName), noThreads(1), pageJobs(), headerText(master.headerText), footerText(master.footerText), navigationKey(master.navigationKey), search(master.search), minify(master.minify), sharedNavigation(master.sharedNavigation) {};
 
 public:
 
-	ProcessHtml(string & bfn, string & ffn, const bool & ver) : ProcessHat(bfn), footerFileName(ffn) {verbose = ver;};
+	ProcessHtml(HatDocument * doc, HatOutput * out, string & bfn, string & ffn, const bool & ver, const unsigned int & nt = 1) : ProcessHat(doc, out, bfn), citations(), missingCitations(), footerFileName(ffn), noThreads(nt), pageJobs(), headerText(""), footerText(""), navigationKey(0), search(false), minify(false), sharedNavigation(false) {verbose = ver;};
 
 	virtual ~ProcessHtml()
 	{
-		for(map<string, Citation *>::iterator c = citations.begin(); c != citations.end(); ++c)
+		for(list<Citation *>::iterator c = missingCitations.begin(); c != missingCitations.end(); ++c)
 		{
-			delete c->second;
+			delete *c;
 		};
 	};
 
 	void process(string & filename);
-	void processWord(string & word, ifstream & fileIn, ostream & fileOut, bool replaceChars = true);
-	void getSectionNameAndTitle(ifstream & fileIn, ostream & fileOut, string & sectionName, string & sectionTitle);
-	void addReferencesWebpage(ifstream & fileIn, ostream & fileOut);
+	void processPages(string & filename, ofstream & fileOut);
+	void addNavigationKey();
+	Section * getPageSection(string & sectionName, HatStream & fileIn);
+	unsigned long long getPageKey(Section * section);
+	bool skipSectionPage(string & sectionName, HatStream & fileIn);
+	bool addPageJob(string & sectionName, string & sectionTitle, HatStream & fileIn);
+	bool processPageJobs();
+	void processPageJobsThread(unsigned int * nextJob, mutex * jobLock);
+	void processSectionPage(string & sectionName, string & sectionTitle, HatStream & fileIn, unsigned int depth);
+	void processWord(string & word, HatStream & fileIn, ostream & fileOut, bool replaceChars = true);
+	void getSectionNameAndTitle(HatStream & fileIn, ostream & fileOut, string & sectionName, string & sectionTitle);
+	void addReferencesWebpage(HatStream & fileIn, ostream & fileOut);
+	string getFirstPage();
+	void setSearch(const bool & se) {search = se;};
+	void setMinify(const bool & mi) {minify = mi;};
+	void setSharedNavigation(const bool & sn) {sharedNavigation = sn;};
+	void addContentsFiles(HatStream & fileIn);
+	void addSearchWebpage(string & filename, HatStream & fileIn);
+	void addSearchWords(const string & filename, HatSearch & hatSearch, vector<string> & targetLinks);
 	void addCitation(const string & citeName);
 	void addReferences(string & filename, ostream & fileOut);
 	string getFileOutName(string & filename);
-	void processSection(ifstream & fileIn, ostream & fileOut, unsigned int depth);
-	void processWebpage(ifstream & fileIn, ostream & fileOut);
+	void processSection(HatStream & fileIn, ostream & fileOut, unsigned int depth);
+	void processWebpage(HatStream & fileIn, ostream & fileOut);
 	void startSection(ostream & fileOut, Section * section, unsigned int & depth);
 	void endSection(ostream & fileOut, Section * section, unsigned int & depth);
+	void addPageOrder();
 	void addNextAndPrev(ostream & fileOut, Section * section);
 	void startParagraph(ostream & fileOut);
 	void endParagraph(ostream & fileOut);
-	void processHtml(ifstream & fileIn, ostream & fileOut);
-	void processTex(ifstream & fileIn, ostream & fileOut);
-	void header(ifstream & fileIn, ostream & fileOut);
-	void footer(ifstream & fileIn, ostream & fileOut);
-	void menu(ifstream & fileIn, ostream & fileOut);
-	void contents(ifstream & fileIn, ostream & fileOut);
-	void processCode(ifstream & fileIn, ostream & fileOut, bool start);
-	void processCodeExample(ifstream & fileIn, ostream & fileOut);
-	void processCodeExampleSmall(ifstream & fileIn, ostream & fileOut);
-	void processTable(ifstream & fileIn, ostream & fileOut, const unsigned int & align = 1, const bool & scale = false);
-	void processFigure(ifstream & fileIn, ostream & fileOut);
-	void processList(ifstream & fileIn, ostream & fileOut, const bool & numList);
-	void processRef(ifstream & fileIn, ostream & fileOut);
-	void processFigRef(ifstream & fileIn, ostream & fileOut);
-	void processBold(string & word, ifstream & fileIn, ostream & fileOut, bool start);
-	void processItalic(string & word, ifstream & fileIn, ostream & fileOut, bool start);
-	void processUnderline(string & word, ifstream & fileIn, ostream & fileOut, bool start);
-	void processLatexFormula(string & word, ifstream & fileIn, ostream & fileOut);
-	void processQuote(ifstream & fileIn, ostream & fileOut, bool start);
-	void processQuoteOneWord(string & word, ifstream & fileIn, ostream & fileOut);
-	void processPercent(ifstream & fileIn, ostream & fileOut);
-	void processCite(ifstream & fileIn, ostream & fileOut, bool start);
+	void processHtml(HatStream & fileIn, ostream & fileOut);
+	void processTex(HatStream & fileIn, ostream & fileOut);
+	void addHeaderText(HatStream & fileIn);
+	void header(HatStream & fileIn, ostream & fileOut);
+	void footer(HatStream & fileIn, ostream & fileOut);
+	void menu(HatStream & fileIn, ostream & fileOut);
+	void contents(HatStream & fileIn, ostream & fileOut);
+	void contentsList(ostream & fileOut);
+	void processCode(HatStream & fileIn, ostream & fileOut, bool start);
+	void processCodeExample(HatStream & fileIn, ostream & fileOut);
+	void processCodeExampleSmall(HatStream & fileIn, ostream & fileOut);
+	void processTable(HatStream & fileIn, ostream & fileOut, const unsigned int & align = 1, const bool & scale = false);
+	void processFigure(HatStream & fileIn, ostream & fileOut);
+	void processList(HatStream & fileIn, ostream & fileOut, const bool & numList);
+	void processRef(HatStream & fileIn, ostream & fileOut);
+	void processFigRef(HatStream & fileIn, ostream & fileOut);
+	void processBold(string & word, HatStream & fileIn, ostream & fileOut, bool start);
+	void processItalic(string & word, HatStream & fileIn, ostream & fileOut, bool start);
+	void processUnderline(string & word, HatStream & fileIn, ostream & fileOut, bool start);
+	void processLatexFormula(string & word, HatStream & fileIn, ostream & fileOut);
+	void processQuote(HatStream & fileIn, ostream & fileOut, bool start);
+	void processQuoteOneWord(string & word, HatStream & fileIn, ostream & fileOut);
+	void processPercent(HatStream & fileIn, ostream & fileOut);
+	void processCite(HatStream & fileIn, ostream & fileOut, bool start);
 	void replaceSpecialChars(string & aString);
 
-	void addFooterText(ostream & fileOut);
+	void addFooterText();
+};
+
+//a section page which is written in its own thread after the main pass has moved past it
+struct PageJob
+{
+	ProcessHtml * renderer; //a copy of the html processing, with its own created files and messages
+	HatStream fileIn; //positioned after the section title
+	string sectionName;
+	string sectionTitle;
+	unsigned int sourceEnd;
+	list<string>::iterator fileNamePos; //where the files of the page go in the list of created files
+	size_t logPos; //where the messages of the page go in the collected messages
+	size_t warningPos;
+	bool failed; //a fatal error stopped the page
+
+	PageJob(ProcessHtml * re, HatStream & fi, string & sn, string & st, unsigned int se, list<string>::iterator fnp, size_t lp, size_t wp)
+		: renderer(re), fileIn(fi), sectionName(sn), sectionTitle(st), sourceEnd(se), fileNamePos(fnp), logPos(lp), warningPos(wp), failed(false) {};
+
+	~PageJob()
+	{
+		delete renderer;
+	};
 };
 
 class ProcessTex : public ProcessHat
 {
 private:
 	
-	
+	bool splitTex; //write each top level section to its own file for \include
+	string fileOutBase; //tex file name without .tex, for the names of the section files
+	list<string> sectionFileNames; //as given to \include
 
 public:
 
-	ProcessTex(string & bfn, string & tfn, const bool & ver) : ProcessHat(bfn, tfn) {verbose = ver;};
+	ProcessTex(HatDocument * doc, HatOutput * out, string & bfn, string & tfn, const bool & ver) : ProcessHat(doc, out, bfn, tfn), splitTex(false), fileOutBase(""), sectionFileNames() {verbose = ver;};
 
 	virtual ~ProcessTex()
 	{
 		
 	};
 
+	void process(string & filename);
 	string getFileOutName(string & filename);
-	void processSection(ifstream & fileIn, ostream & fileOut, unsigned int depth);
+	void setSplitTex(const bool & split) {splitTex = split;};
+	void addBuildKey(string & keyText);
+	string getIncludeName(const string & name);
+	void processSection(HatStream & fileIn, ostream & fileOut, unsigned int depth);
 	void startSection(ostream & fileOut, Section * section, unsigned int & depth);
-	void getSectionNameAndTitle(ifstream & fileIn, ostream & fileOut, string & sectionName, string & sectionTitle);
-	void processWebpage(ifstream & fileIn, ostream & fileOut);
+	void getSectionNameAndTitle(HatStream & fileIn, ostream & fileOut, string & sectionName, string & sectionTitle);
+	void processWebpage(HatStream & fileIn, ostream & fileOut);
 	void endSection(ostream & fileOut, Section * section, unsigned int & depth);
 	void startParagraph(ostream & fileOut);
 	void endParagraph(ostream & fileOut);
-	void processHtml(ifstream & fileIn, ostream & fileOut);
-	void processTex(ifstream & fileIn, ostream & fileOut);
-	void header(ifstream & fileIn, ostream & fileOut);
-	void footer(ifstream & fileIn, ostream & fileOut);
-	void contents(ifstream & fileIn, ostream & fileOut) {};
-	void processCode(ifstream & fileIn, ostream & fileOut, bool start);
-	void processCodeExample(ifstream & fileIn, ostream & fileOut);
-	void processCodeExampleSmall(ifstream & fileIn, ostream & fileOut);
-	void processTable(ifstream & fileIn, ostream & fileOut, const unsigned int & align = 1, const bool & scale = false);
-	void processFigure(ifstream & fileIn, ostream & fileOut);
-	void processList(ifstream & fileIn, ostream & fileOut, const bool & numList);
-	void processRef(ifstream & fileIn, ostream & fileOut);
-	void processFigRef(ifstream & fileIn, ostream & fileOut);
-	void processBold(string & word, ifstream & fileIn, ostream & fileOut, bool start);
-	void processItalic(string & word, ifstream & fileIn, ostream & fileOut, bool start);
-	void processUnderline(string & word, ifstream & fileIn, ostream & fileOut, bool start);
-	void processLatexFormula(string & word, ifstream & fileIn, ostream & fileOut);
-	void processQuote(ifstream & fileIn, ostream & fileOut, bool start);
-	void processQuoteOneWord(string & word, ifstream & fileIn, ostream & fileOut);
-	void processPercent(ifstream & fileIn, ostream & fileOut);
-	void processCite(ifstream & fileIn, ostream & fileOut, bool start);
+	void processHtml(HatStream & fileIn, ostream & fileOut);
+	void processTex(HatStream & fileIn, ostream & fileOut);
+	void header(HatStream & fileIn, ostream & fileOut);
+	void footer(HatStream & fileIn, ostream & fileOut);
+	void addIncludeOnlyFile();
+	void contents(HatStream & fileIn, ostream & fileOut) {};
+	void processCode(HatStream & fileIn, ostream & fileOut, bool start);
+	void processCodeExample(HatStream & fileIn, ostream & fileOut);
+	void processCodeExampleSmall(HatStream & fileIn, ostream & fileOut);
+	void processTable(HatStream & fileIn, ostream & fileOut, const unsigned int & align = 1, const bool & scale = false);
+	void processFigure(HatStream & fileIn, ostream & fileOut);
+	void processList(HatStream & fileIn, ostream & fileOut, const bool & numList);
+	void processRef(HatStream & fileIn, ostream & fileOut);
+	void processFigRef(HatStream & fileIn, ostream & fileOut);
+	void processBold(string & word, HatStream & fileIn, ostream & fileOut, bool start);
+	void processItalic(string & word, HatStream & fileIn, ostream & fileOut, bool start);
+	void processUnderline(string & word, HatStream & fileIn, ostream & fileOut, bool start);
+	void processLatexFormula(string & word, HatStream & fileIn, ostream & fileOut);
+	void processQuote(HatStream & fileIn, ostream & fileOut, bool start);
+	void processQuoteOneWord(string & word, HatStream & fileIn, ostream & fileOut);
+	void processPercent(HatStream & fileIn, ostream & fileOut);
+	void processCite(HatStream & fileIn, ostream & fileOut, bool start);
 };
 
 #endif
@@ -7,11 +7,21 @@
 #include <iostream>
 #include <ostream>
 #include <cstdlib>
+#include <climits>
+#include <fstream>
+#include <sstream>
+#include <vector>
+#include <list>
+#include <thread>
+#include <mutex>
+#include <chrono>
 
 using namespace std; // initiates the "std" or "standard" namespace
  
 #include "main.h"
 #include "ProcessHat.h"
+#include "HatWatch.h"
+#include "HatServer.h"
 
 void header()
 {
@@ -23,74 +33,515 @@ void usage()
 {
 	header();
 	cout << "Author: Richard Howey, Research Software Engineering, Newcastle University\n\n"   
-		<< "Usage:\n\t ./hatdoc [options] file.hat [bibtexfile.bib]\n\n"		
+		<< "Usage:\n\t ./hatdoc [options] file.hat [bibtexfile.bib]\n\t ./hatdoc [options] --batch batch.txt\n\n"		
 		<< "Options:\n"
 		<< "  -f footer.txt      - HTML footer text for the bottom of each page.\n"
 	    << "  -t file.tex        - alternative tex file name.\n"
+		<< "  -o directory       - directory for the output files, on Windows such as C:\\site or C:/site (default: current directory).\n"
+		<< "  -j threads         - number of threads for the TeX and the HTML section pages, 1 processes everything in turn, at most 256 are used (default: number of cores).\n"
+		<< "  --full             - write every file, not only those changed since the last build.\n"
+		<< "  --split-tex        - write each section of the tex file to its own file, included with \\include.\n"
+		<< "  --search           - write search.html to search every page, using an index of the words written to the search directory.\n"
+		<< "  --gzip             - also write a gzip compressed copy of each page and script, e.g. index.html.gz, for web servers to send as it is.\n"
+		<< "  --gzip-level n     - compression level of --gzip from 1 (fastest) to 9 (smallest), sets --gzip (default: 6).\n"
+		<< "  --minify           - write the pages without comments and extra white space.\n"
+		<< "  --shared-nav       - write the contents once to contents.js for every page to load rather than on every page.\n"
+		<< "  --watch            - keep running and build again whenever the .hat, input, bib or footer files change.\n"
+		<< "  --serve            - keep the pages in memory, serve them at http://localhost:8080/ and build again whenever a file changes.\n"
+		<< "  --port port        - port for --serve (default: 8080).\n"
+		<< "  --batch file       - build many documents, each line of the file has the options and files of one document.\n"
+		<< "  --stats            - display the time taken by each phase and counts of tokens, pages, figures, citations and output bytes.\n"
+		<< "  --stats-json file  - write the same statistics as json to a file in the output directory.\n"
 		<< "  -v                 - verbose output.\n";
 };
 
-int main(int argc, char * argv[])
+//processes the html or tex, a fatal error is noted rather than passed on so that it can be passed on after the messages are displayed
+void processOutput(ProcessHat * process, string * fileName, bool * failed)
+{
+	try
+	{
+		process->process(*fileName);
+	}
+	catch(HatError &)
+	{
+		*failed = true;
+	};
+};
+
+//makes the html and tex files from the document, files read in an earlier build are used again if they have not been removed,
+//throws a HatError after displaying the messages if there is a fatal error in the document
+void processDocument(HatDocument & document, HatOutput & output, HatOptions & options, ostream & out, ostream & err)
+{
+	chrono::steady_clock::time_point start = chrono::steady_clock::now();
+	HatStats stats;
+
+	ProcessHtml pHtml(&document, &output, options.bibFileName, options.footerFileName, options.verbose, options.noThreads);
+	ProcessTex pTex(&document, &output, options.bibFileName, options.texFileName, options.verbose);
+	pTex.setSplitTex(options.splitTex);
+	pHtml.setSearch(options.search);
+	pHtml.setGzipLevel(options.gzipLevel);
+	pHtml.setMinify(options.minify);
+	pHtml.setSharedNavigation(options.sharedNavigation);
+
+	if(options.stats || options.statsJsonFileName != "")
+	{
+		pHtml.setStats(&stats);
+		pTex.setStats(&stats);
+	};
+
+	//messages are kept to display afterwards if the tex is processed at the same time or if other documents are being built too
+	bool collect = options.noThreads > 1 || &out != &cout;
+	if(collect)
+	{
+		pHtml.collectMessages();
+		pTex.collectMessages();
+	};
+
+	bool htmlFailed = false;
+	bool texFailed = false;
+
+	if(options.noThreads > 1)
+	{
+		//the html and tex only share the source files, so process the tex in another thread
+		//and display any messages afterwards in the same order as processing one after the other
+		thread texThread(processOutput, &pTex, &options.fileName, &texFailed);
+		processOutput(&pHtml, &options.fileName, &htmlFailed);
+		texThread.join();
+	}
+	else
+	{
+		processOutput(&pHtml, &options.fileName, &htmlFailed);
+		if(!htmlFailed) processOutput(&pTex, &options.fileName, &texFailed);
+	};
+
+	//without threads the tex is not processed after a fatal error in the html, so its messages are not shown either
+	if(collect)
+	{
+		pHtml.displayMessages(out, err);
+		if(!htmlFailed) pTex.displayMessages(out, err);
+	};
+
+	if(htmlFailed || texFailed) throw HatError();
+	
+	if(!options.serve) document.saveBuild(output.getPath(options.buildFileName));
+	document.endBuild();
+	output.publishFiles(pHtml.getFirstPage());
+
+	out << "Output files:\n";
+	pHtml.displayCreatedFiles(out);
+	pTex.displayCreatedFiles(out);
+	out << "\n";
+	pHtml.displayNoSections(out);
+
+	stats.setTotalSeconds(chrono::duration<double>(chrono::steady_clock::now() - start).count());
+	if(options.stats) stats.display(out);
+
+	if(options.statsJsonFileName != "" && !stats.writeJson(output.getPath(options.statsJsonFileName), options.fileName))
+	{
+		err << "Cannot write file: " << output.getPath(options.statsJsonFileName) << "!\n";
+	};
+};
+
+//builds the document again each time one of its files changes
+void watchDocument(HatDocument & document, HatOutput & output, HatOptions & options)
+{
+	HatWatch watch;
+
+	while(true)
+	{
+		//the files read may change from one build to the next, the footer is always read
+		list<string> fileNames = document.getFileNames();
+		fileNames.push_back(options.bibFileName);
+		fileNames.push_back(options.footerFileName);
+		watch.setFiles(fileNames);
+
+		cout << "\nWatching for changes to " << options.fileName << " and its files (Ctrl-C to stop)...\n";
+		list<string> changedFiles = watch.waitForChanges();
+
+		cout << "\nChanged:";
+		for(list<string>::const_iterator f = changedFiles.begin(); f != changedFiles.end(); ++f)
+		{
+			cout << " " << *f;
+			document.removeFile(*f);
+		};
+		cout << "\n\n";
+
+		try
+		{
+			processDocument(document, output, options, cout, cerr);
+		}
+		catch(HatError &)
+		{
+			document.failBuild();
+			cerr << "\nBuild failed, waiting for changes to build again\n";
+		};
+	};
+};
+
+//reads the value of a command line switch, returns false if it is not a whole number from min to max, LONG_MAX for no maximum
+bool getNumberOption(const string & option, const string & value, const long & min, const long & max, long & number)
+{
+	char * end = 0;
+	number = strtol(value.c_str(), &end, 10);
+
+	if(value == "" || *end != '\0' || number < min || number > max)
+	{
+		cerr << "\nThe value of command line switch " << option << " must be a whole number ";
+		if(max == LONG_MAX) cerr << "of at least " << min; else cerr << "from " << min << " to " << max;
+		cerr << ": " << value << "\n";
+		return false;
+	};
+
+	return true;
+};
+
+//sets the options from the command line or a line of a batch file, returns false if an option is not known
+bool setOptions(const vector<string> & args, HatOptions & options)
 {
-	int argcount = 1;
-	string fileName;
-	string bibFileName = "";
-	string footerFileName = "";
-	string texFileName = "";
+	unsigned int argcount = 0;
 	string option = "";
-	bool verbose = false;
+	long number = 0;
 
-	while(argcount < argc && argv[argcount][0] == '-')
+	while(argcount < args.size() && args[argcount][0] == '-')
     {
-		option = argv[argcount];
-		if(option == "-f")
+		option = args[argcount];
+
+		//options with a value
+		if(option == "-f" || option == "-t" || option == "-j" || option == "-o" || option == "--port" || option == "--batch" || option == "--stats-json" || option == "--gzip-level")
 		{
 			argcount++;
-			footerFileName = argv[argcount];	
+			if(argcount >= args.size())
+			{
+				cerr << "\nNo value given for command line switch: " << option << "\n";
+				return false;
+			};
+		};
+
+		if(option == "-f")
+		{
+			options.footerFileName = args[argcount];	
 		}
 		else if(option == "-t")
 		{
-			argcount++;
-			texFileName = argv[argcount];	
+			options.texFileName = args[argcount];	
+		}
+		else if(option == "-o")
+		{
+			options.outputDirectory = args[argcount];	
+		}
+		else if(option == "-j")
+		{
+			//more threads than there are pages to write are never used, so a very large number is only limited
+			if(!getNumberOption(option, args[argcount], 1, LONG_MAX, number)) return false;
+			options.noThreads = number < (long)maxNoThreads ? number : maxNoThreads;
+		}
+		else if(option == "--full")
+		{
+			options.fullBuild = true;
+		}
+		else if(option == "--split-tex")
+		{
+			options.splitTex = true;
+		}
+		else if(option == "--search")
+		{
+			options.search = true;
+		}
+		else if(option == "--gzip")
+		{
+#ifdef HAT_NO_ZLIB
+			cerr << "\nCompressed copies with --gzip are not available, hatdocs was compiled without zlib\n";
+			return false;
+#else
+			if(options.gzipLevel == 0) options.gzipLevel = 6;
+#endif
+		}
+		else if(option == "--gzip-level")
+		{
+#ifdef HAT_NO_ZLIB
+			cerr << "\nCompressed copies with --gzip-level are not available, hatdocs was compiled without zlib\n";
+			return false;
+#else
+			if(!getNumberOption(option, args[argcount], 1, 9, number)) return false;
+			options.gzipLevel = number;
+#endif
+		}
+		else if(option == "--minify")
+		{
+			options.minify = true;
+		}
+		else if(option == "--shared-nav")
+		{
+			options.sharedNavigation = true;
+		}
+		else if(option == "--watch")
+		{
+			options.watch = true;
+		}
+		else if(option == "--serve")
+		{
+#ifdef _WIN32
+			cerr << "\nServing pages with --serve is not available on Windows, use --watch instead\n";
+			return false;
+#else
+			options.serve = true;
+#endif
+		}
+		else if(option == "--port")
+		{
+			if(!getNumberOption(option, args[argcount], 1, 65535, number)) return false;
+			options.port = number;
+		}
+		else if(option == "--batch")
+		{
+			options.batchFileName = args[argcount];
+		}
+		else if(option == "--stats")
+		{
+			options.stats = true;
+		}
+		else if(option == "--stats-json")
+		{
+			options.statsJsonFileName = args[argcount];
 		}
 		else if(option == "-v")
 		{
-			verbose = true;	
+			options.verbose = true;	
 		}
 		else
 		{
     		cerr << "\nUnrecognised command line switch: " << option << "\n";
-			usage();
-    		exit(1);
+			return false;
 		};
 
 		argcount++;
 	};
 
-	if(argcount < argc)
+	if(argcount < args.size()) options.fileName = args[argcount++];
+	if(argcount < args.size()) options.bibFileName = args[argcount++];
+
+	return true;
+};
+
+//a document of a batch and its messages, which are displayed in the order of the batch file
+struct BatchDocument
+{
+	HatOptions options;
+	ostringstream out;
+	ostringstream err;
+	bool done;
+	bool failed; //a fatal error stopped the document
+
+	BatchDocument(const HatOptions & op) : options(op), out(), err(), done(false), failed(false) {};
+};
+
+//builds the documents of a batch in turn until there are none left, the source and bib files are shared by all of the documents
+void processBatchDocuments(vector<BatchDocument *> * documents, HatDocument * sharedFiles, unsigned int * nextDocument, unsigned int * nextToDisplay, mutex * batchLock)
+{
+	unsigned int documentNo;
+
+	while(true)
+	{
+		{
+			lock_guard<mutex> lock(*batchLock);
+			documentNo = (*nextDocument)++;
+		};
+
+		if(documentNo >= documents->size()) return;
+
+		BatchDocument * batchDocument = (*documents)[documentNo];
+		HatDocument document(sharedFiles);
+		HatOutput output(batchDocument->options.outputDirectory);
+
+		batchDocument->out << "Input file: " << batchDocument->options.fileName << "\n";
+		if(batchDocument->options.outputDirectory != "") batchDocument->out << "Output directory: " << batchDocument->options.outputDirectory << "\n";
+		batchDocument->out << "\n";
+
+		if(!batchDocument->options.fullBuild) document.loadBuild(output.getPath(batchDocument->options.buildFileName));
+
+		//a fatal error only stops this document, the others of the batch are still built
+		try
+		{
+			processDocument(document, output, batchDocument->options, batchDocument->out, batchDocument->err);
+		}
+		catch(HatError &)
+		{
+			batchDocument->err << "Cannot build document: " << batchDocument->options.fileName << "!\n";
+			batchDocument->failed = true;
+		};
+
+		//display the messages of any documents that are done and have not been displayed yet
+		lock_guard<mutex> lock(*batchLock);
+		batchDocument->done = true;
+
+		while(*nextToDisplay < documents->size() && (*documents)[*nextToDisplay]->done)
+		{
+			cout << (*documents)[*nextToDisplay]->out.str() << "\n";
+			cerr << (*documents)[*nextToDisplay]->err.str();
+			cout.flush();
+			(*nextToDisplay)++;
+		};
+	};
+};
+
+//builds every document in a batch file, each line has the options and files of one document as on the command line
+void processBatch(HatOptions & options)
+{
+	ifstream batchIn(options.batchFileName.c_str());
+	if(!batchIn.is_open())
+	{
+		cerr << "Cannot read file: " << options.batchFileName << "!\n";
+		exit(1);
+	};
+
+	vector<BatchDocument *> documents;
+	string line, arg;
+	unsigned int lineNo = 0;
+
+	while(getline(batchIn, line))
+	{
+		lineNo++;
+
+		vector<string> args;
+		istringstream lineIn(line);
+		while(lineIn >> arg) args.push_back(arg);
+
+		if(args.empty() || args[0][0] == '#') continue;
+
+		//each document starts with the options given on the command line
+		HatOptions documentOptions = options;
+		documentOptions.fileName = "";
+		documentOptions.bibFileName = "";
+		documentOptions.batchFileName = "";
+
+		if(!setOptions(args, documentOptions) || documentOptions.fileName == "" || documentOptions.watch || documentOptions.serve || documentOptions.batchFileName != "")
+		{
+			cerr << "Cannot use line " << lineNo << " of batch file " << options.batchFileName << ": " << line << "\n";
+			exit(1);
+		};
+
+		documents.push_back(new BatchDocument(documentOptions));
+	};
+
+	batchIn.close();
+
+	if(documents.empty()) return;
+
+	//build as many documents at once as there are threads, splitting any spare threads between them
+	unsigned int noBatchThreads = options.noThreads;
+	if(noBatchThreads > documents.size()) noBatchThreads = documents.size();
+
+	for(vector<BatchDocument *>::iterator d = documents.begin(); d != documents.end(); ++d)
+	{
+		if((*d)->options.noThreads == options.noThreads) (*d)->options.noThreads = options.noThreads / noBatchThreads;
+	};
+
+	HatDocument sharedFiles;
+	unsigned int nextDocument = 0;
+	unsigned int nextToDisplay = 0;
+	mutex batchLock;
+
+	list<thread> batchThreads;
+	for(unsigned int t = 1; t < noBatchThreads; ++t)
+	{
+		batchThreads.push_back(thread(processBatchDocuments, &documents, &sharedFiles, &nextDocument, &nextToDisplay, &batchLock));
+	};
+
+	processBatchDocuments(&documents, &sharedFiles, &nextDocument, &nextToDisplay, &batchLock);
+
+	for(list<thread>::iterator t = batchThreads.begin(); t != batchThreads.end(); ++t)
+	{
+		t->join();
+	};
+
+	cout << "Number of documents: " << documents.size() << "\n";
+
+	unsigned int noFailed = 0;
+	for(vector<BatchDocument *>::iterator d = documents.begin(); d != documents.end(); ++d)
+	{
+		if((*d)->failed) noFailed++;
+		delete *d;
+	};
+
+	if(noFailed > 0)
+	{
+		cerr << "Number of documents not built: " << noFailed << "\n";
+		exit(1);
+	};
+};
+
+int main(int argc, char * argv[])
+{
+	HatOptions options;
+	vector<string> args;
+	for(int i = 1; i < argc; ++i) args.push_back(argv[i]);
+
+	if(!setOptions(args, options))
+	{
+		usage();
+		exit(1);
+	};
+
+	if(options.batchFileName != "")
 	{
 		header();
+		cout << "Batch file: " << options.batchFileName << "\n\n";
 
-		fileName = argv[argcount++];
-		
-		if(argcount < argc) bibFileName = argv[argcount++];
+		processBatch(options);
+	}
+	else if(options.fileName != "")
+	{
+		header();
 
-		cout << "Input file: "<< fileName <<"\n";
-		if(bibFileName != "") cout << "Bibtex file: " << bibFileName << "\n";
+		cout << "Input file: "<< options.fileName <<"\n";
+		if(options.bibFileName != "") cout << "Bibtex file: " << options.bibFileName << "\n";
 		cout << "\n";
 
-		ProcessHtml pHtml(bibFileName, footerFileName, verbose);
-		pHtml.process(fileName);
+		HatDocument document;
 
-		ProcessTex pTex(bibFileName, texFileName, verbose);
-		pTex.process(fileName);
+		if(options.serve)
+		{
+			//build into memory then serve the pages while building again in another thread whenever a file changes
+			HatMemoryOutput output;
+			try
+			{
+				processDocument(document, output, options, cout, cerr);
+			}
+			catch(HatError &)
+			{
+				exit(1);
+			};
 
-		
-		cout << "Output files:\n";
-		pHtml.displayCreatedFiles();
-		pTex.displayCreatedFiles();
-		cout << "\n";
-		pHtml.displayNoSections();
+			thread watchThread(watchDocument, ref(document), ref(output), ref(options));
+
+			HatServer server(&output, options.port);
+			if(!server.serve())
+			{
+				cerr << "Cannot serve pages on port " << options.port << "!\n";
+				exit(1);
+			};
+		}
+		else
+		{
+			HatOutput output(options.outputDirectory);
+
+			//what each output was made from is kept so outputs that have not changed need not be made again
+			if(!options.fullBuild) document.loadBuild(output.getPath(options.buildFileName));
+
+			try
+			{
+				processDocument(document, output, options, cout, cerr);
+			}
+			catch(HatError &)
+			{
+				//with --watch the document is built again once the error is fixed
+				if(!options.watch) exit(1);
+				document.failBuild();
+				cerr << "\nBuild failed, waiting for changes to build again\n";
+			};
+
+			if(options.watch) watchDocument(document, output, options);
+		};
 	}
 	else
 	{
@@ -98,4 +549,3 @@ int main(int argc, char * argv[])
 	};
 
 };
-
@@ -7,5 +7,39 @@
 #ifndef __MAIN
 #define __MAIN
 
+#include <string>
+#include <thread>
+
+const unsigned int maxNoThreads = 256; //a larger -j is taken as this
+
+//the command line options
+struct HatOptions
+{
+	string fileName;
+	string bibFileName;
+	string footerFileName;
+	string texFileName;
+	string outputDirectory;
+	string buildFileName; //what each output was made from, in the output directory
+	string batchFileName; //documents to build together
+	bool verbose;
+	bool fullBuild;
+	bool splitTex; //each top level section in its own tex file
+	bool search; //write a search index and page
+	int gzipLevel; //of the compressed copies of pages, 0 for none
+	bool minify; //pages without comments and extra white space
+	bool sharedNavigation; //contents in one file loaded by every page
+	bool watch;
+	bool serve; //keep the pages in memory and serve them on localhost
+	bool stats; //display times and counts
+	string statsJsonFileName; //file for the times and counts as json, in the output directory
+	unsigned int port;
+	unsigned int noThreads;
+
+	HatOptions() : fileName(""), bibFileName(""), footerFileName(""), texFileName(""), outputDirectory(""), buildFileName("hatdocs.hatbuild"), batchFileName(""), verbose(false), fullBuild(false), splitTex(false), search(false), gzipLevel(0), minify(false), sharedNavigation(false), watch(false), serve(false), stats(false), statsJsonFileName(""), port(8080), noThreads(thread::hardware_concurrency())
+	{
+		if(noThreads == 0) noThreads = 1;
+	};
+};
 
 #endif
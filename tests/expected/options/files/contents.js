@@ -0,0 +1 @@
+document.getElementById("navcontainer").innerHTML = "<ul><li><a href=\"intro.html\">1 Introduction<\/a> <\/li> <li><a href=\"options.html\">2 Options<\/a><ul><li><a href=\"basic.html\">2.1 Basic options<\/a><\/li> <li><a href=\"advanced.html\">2.2 Advanced options online<\/a><\/li><\/ul><\/li> <li><a href=\"chapter.html\">3 A chapter from another file<\/a> <\/li> <li><a href=\"part.html\">4 A section from a nested input file<\/a><ul><li><a href=\"part.html#partsub\">4.1 A subsection on the same page<\/a><\/li><\/ul><\/li> <li><a href=\"maths.html\">5 Formulas and tables<\/a><ul><li><a href=\"formulas.html\">5.1 More formulas<\/a><\/li> <li><a href=\"tables.html\">5.2 Option tables<\/a><\/li><\/ul><\/li> <li><a href=\"references.html\">References<\/a><\/li> <li><a href=\"search.html\">Search<\/a><\/li><\/ul>";
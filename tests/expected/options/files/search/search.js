@@ -0,0 +1,79 @@
+var hatSearch = {
+targets: null,
+shards: {},
+loading: {},
+maxResults: 50,
+addTargets: function(targets) {this.targets = targets; this.search();},
+addTerms: function(shard, terms) {this.shards[shard] = terms; this.search();},
+getTerms: function(text) {
+	return text.toLowerCase().split(/[^a-z0-9\u0080-\uffff]+/).filter(function(term) {return term.length > 0;});
+},
+getShard: function(term) {
+	var first = term.charAt(0);
+	return /[a-z0-9]/.test(first) ? first : "_";
+},
+load: function(fileName) {
+	if(this.loading[fileName]) return;
+	this.loading[fileName] = true;
+	var script = document.createElement("script");
+	script.type = "text/javascript";
+	script.src = "search/" + fileName + ".js";
+	document.body.appendChild(script);
+},
+getPostings: function(term, startsWith) {
+	var terms = this.shards[this.getShard(term)];
+	var postings = {};
+	for(var t in terms) {
+		if(t != term && !(startsWith && t.lastIndexOf(term, 0) == 0)) continue;
+		terms[t].forEach(function(p) {
+			var positions = postings[p[0]] || (postings[p[0]] = []);
+			for(var i = 1, pos = 0; i < p.length; ++i) {pos += p[i]; positions.push(pos);}
+		});
+	}
+	return postings;
+},
+search: function() {
+	var results = document.getElementById("searchresults");
+	var terms = this.getTerms(document.getElementById("searchtext").value);
+	if(terms.length == 0) {results.innerHTML = ""; return;}
+	if(this.targets == null) {this.load("targets"); return;}
+	var loaded = true;
+	for(var i = 0; i < terms.length; ++i) {
+		var shard = this.getShard(terms[i]);
+		if(!(shard in this.shards)) {this.load("terms-" + shard); loaded = false;}
+	}
+	if(!loaded) return;
+	var matches = null;
+	for(var i = 0; i < terms.length; ++i) {
+		var postings = this.getPostings(terms[i], i == terms.length - 1);
+		if(matches == null) {
+			matches = {};
+			for(var t in postings) matches[t] = {score: postings[t].length, positions: postings[t]};
+			continue;
+		}
+		for(var t in matches) {
+			if(!(t in postings)) {delete matches[t]; continue;}
+			var before = {};
+			matches[t].positions.forEach(function(pos) {before[pos + 1] = true;});
+			var noNext = postings[t].filter(function(pos) {return before[pos];}).length;
+			matches[t].score += postings[t].length + 10 * noNext;
+			matches[t].positions = postings[t];
+		}
+	}
+	var found = Object.keys(matches).sort(function(a, b) {return matches[b].score - matches[a].score || a - b;});
+	results.innerHTML = "";
+	var summary = document.createElement("p");
+	summary.textContent = found.length == 0 ? "No pages found." : found.length == 1 ? "1 page found." : found.length + " pages found.";
+	results.appendChild(summary);
+	var list = document.createElement("ol");
+	for(var i = 0; i < found.length && i < this.maxResults; ++i) {
+		var item = document.createElement("li");
+		var link = document.createElement("a");
+		link.href = this.targets[found[i]][0];
+		link.innerHTML = this.targets[found[i]][1];
+		item.appendChild(link);
+		list.appendChild(item);
+	}
+	results.appendChild(list);
+}
+};
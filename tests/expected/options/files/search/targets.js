@@ -0,0 +1,14 @@
+hatSearch.addTargets([
+["intro.html","1 Introduction"],
+["options.html","2 Options"],
+["basic.html","2.1 Basic options"],
+["advanced.html","2.2 Advanced options online"],
+["advanced.html#threads","2.2.1 Threads"],
+["chapter.html","3 A chapter from another file"],
+["part.html","4 A section from a nested input file"],
+["part.html#partsub","4.1 A subsection on the same page"],
+["maths.html","5 Formulas and tables"],
+["formulas.html","5.1 More formulas"],
+["tables.html","5.2 Option tables"],
+["download.html","Download"]
+]);
@@ -0,0 +1,4 @@
+hatSearch.addTerms("1",{
+"1":[[9,8,4],[10,41]],
+"10":[[7,12],[9,30]]
+});
@@ -0,0 +1,3 @@
+hatSearch.addTerms("2",{
+"2":[[8,15],[9,21],[10,42]]
+});
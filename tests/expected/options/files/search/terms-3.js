@@ -0,0 +1,3 @@
+hatSearch.addTerms("3",{
+
+});
@@ -0,0 +1,3 @@
+hatSearch.addTerms("4",{
+"4":[[4,13],[10,35]]
+});
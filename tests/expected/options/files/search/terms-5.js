@@ -0,0 +1,3 @@
+hatSearch.addTerms("5",{
+"50":[[0,57]]
+});
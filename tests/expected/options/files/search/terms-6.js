@@ -0,0 +1,3 @@
+hatSearch.addTerms("6",{
+"6":[[10,18]]
+});
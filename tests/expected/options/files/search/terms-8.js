@@ -0,0 +1,3 @@
+hatSearch.addTerms("8",{
+"8080":[[10,22]]
+});
@@ -0,0 +1,3 @@
+hatSearch.addTerms("9",{
+"95":[[9,25]]
+});
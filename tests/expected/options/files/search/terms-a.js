@@ -0,0 +1,13 @@
+hatSearch.addTerms("a",{
+"a":[[0,21,28,6,4],[4,18,10],[5,0],[6,0,3],[7,0,9],[8,18,3,4],[9,35],[10,2,24,10,3]],
+"advanced":[[3,0]],
+"again":[[3,4]],
+"aligned":[[10,4,24]],
+"alpha":[[8,16]],
+"amounts":[[9,27]],
+"and":[[0,10,46],[5,11],[7,11],[8,1,8,8],[9,16,10],[10,8]],
+"another":[[5,3]],
+"are":[[0,34],[2,5],[6,12]],
+"as":[[5,21],[8,13,14],[9,24,5]],
+"at":[[5,18]]
+});
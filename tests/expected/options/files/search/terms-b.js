@@ -0,0 +1,7 @@
+hatSearch.addTerms("b",{
+"b":[[8,19],[10,40]],
+"bar":[[9,5]],
+"basic":[[2,0,3]],
+"below":[[0,39],[2,7]],
+"bib":[[4,17,8],[9,45]]
+});
@@ -0,0 +1,8 @@
+hatSearch.addTerms("c",{
+"c":[[8,20,11]],
+"centred":[[10,37]],
+"chapter":[[5,1]],
+"citation":[[4,19]],
+"code":[[0,60],[9,37]],
+"compression":[[10,19]]
+});
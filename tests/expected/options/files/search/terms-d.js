@@ -0,0 +1,6 @@
+hatSearch.addTerms("d",{
+"default":[[10,14]],
+"details":[[0,20]],
+"directory":[[0,44],[2,12]],
+"download":[[11,0,1]]
+});
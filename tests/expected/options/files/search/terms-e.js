@@ -0,0 +1,5 @@
+hatSearch.addTerms("e",{
+"each":[[1,1]],
+"end":[[5,20],[8,24]],
+"example":[[4,10],[9,38]]
+});
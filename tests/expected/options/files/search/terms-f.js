@@ -0,0 +1,13 @@
+hatSearch.addTerms("f",{
+"f":[[2,13],[9,49]],
+"figure":[[0,22,7]],
+"file":[[4,26],[5,4,9],[6,6]],
+"first":[[7,14]],
+"follows":[[0,23]],
+"footer":[[2,16],[9,50]],
+"for":[[0,11],[2,9,5],[4,9],[10,24]],
+"formula":[[8,22]],
+"formulas":[[8,0,11],[9,1]],
+"frac":[[9,7]],
+"from":[[5,2],[6,2],[11,4]]
+});
@@ -0,0 +1,5 @@
+hatSearch.addTerms("g",{
+"give":[[0,18]],
+"gives":[[4,27]],
+"gzip":[[10,16]]
+});
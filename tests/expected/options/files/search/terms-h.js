@@ -0,0 +1,6 @@
+hatSearch.addTerms("h",{
+"has":[[5,14],[7,8],[8,10]],
+"hat":[[4,15],[9,43,10]],
+"hatdocs":[[4,11],[9,39,7]],
+"here":[[8,32]]
+});
@@ -0,0 +1,10 @@
+hatSearch.addTerms("i",{
+"i":[[9,11,4]],
+"in":[[0,16,20],[4,23],[5,22],[8,28],[10,10]],
+"input":[[5,10],[6,5],[8,8]],
+"introduction":[[0,0]],
+"is":[[1,6],[4,21],[5,7],[8,5],[9,4,15]],
+"italic":[[0,53]],
+"item":[[7,15,3]],
+"its":[[1,8]]
+});
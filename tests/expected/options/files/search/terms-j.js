@@ -0,0 +1,3 @@
+hatSearch.addTerms("j",{
+"j":[[0,45],[4,2,10]]
+});
@@ -0,0 +1,6 @@
+hatSearch.addTerms("l",{
+"left":[[10,31]],
+"level":[[10,17,3]],
+"line":[[5,17]],
+"listed":[[0,35],[2,6]]
+});
@@ -0,0 +1,10 @@
+hatSearch.addTerms("m",{
+"manual":[[0,2],[4,14],[9,42,10]],
+"may":[[8,23]],
+"mean":[[9,3]],
+"meaning":[[0,41],[10,15]],
+"methods":[[0,13]],
+"minify":[[9,41]],
+"more":[[9,0]],
+"mx":[[8,30]]
+});
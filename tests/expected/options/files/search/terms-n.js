@@ -0,0 +1,10 @@
+hatSearch.addTerms("n",{
+"n":[[9,9,4]],
+"name":[[10,32]],
+"nested":[[6,4]],
+"new":[[5,16]],
+"next":[[9,32]],
+"no":[[5,15]],
+"not":[[4,22]],
+"number":[[0,46],[4,6]]
+});
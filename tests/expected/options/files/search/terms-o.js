@@ -0,0 +1,10 @@
+hatSearch.addTerms("o",{
+"o":[[0,42],[2,8],[9,47]],
+"of":[[0,6,20,21,11],[1,3],[4,7],[6,9]],
+"on":[[1,7],[6,13],[7,2]],
+"online":[[3,2]],
+"option":[[0,40],[10,0,13]],
+"options":[[1,0],[2,1,3],[3,1]],
+"output":[[0,5,38],[2,11]],
+"own":[[1,9]]
+});
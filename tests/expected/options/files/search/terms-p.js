@@ -0,0 +1,8 @@
+hatSearch.addTerms("p",{
+"page":[[1,10],[6,16],[7,5]],
+"paragraph":[[0,51]],
+"pdf":[[10,12]],
+"percentages":[[9,22]],
+"port":[[10,21,2]],
+"program":[[0,8],[11,3]]
+});
@@ -0,0 +1,3 @@
+hatSearch.addTerms("q",{
+
+});
@@ -0,0 +1,6 @@
+hatSearch.addTerms("r",{
+"read":[[5,8],[8,6]],
+"refs":[[4,16],[9,44]],
+"results":[[0,15,10,7]],
+"right":[[10,7]]
+});
@@ -0,0 +1,21 @@
+hatSearch.addTerms("s",{
+"s":[[9,20]],
+"same":[[6,15],[7,4]],
+"scaled":[[10,9]],
+"search":[[9,40]],
+"second":[[0,50],[7,17]],
+"section":[[0,17],[1,5],[5,6],[6,1,10],[8,4]],
+"see":[[0,9],[3,3]],
+"sentence":[[8,26]],
+"serve":[[10,25]],
+"set":[[4,4]],
+"shows":[[0,30]],
+"sit":[[9,31]],
+"site":[[9,48]],
+"small":[[9,36]],
+"star":[[7,10]],
+"subsection":[[1,2],[7,1,6]],
+"subsections":[[6,8]],
+"such":[[8,12],[9,23,5]],
+"sum":[[9,10]]
+});
@@ -0,0 +1,13 @@
+hatSearch.addTerms("t",{
+"table":[[0,38],[10,3,24,11]],
+"tables":[[8,2],[10,1]],
+"test":[[0,28]],
+"tests":[[0,3]],
+"that":[[4,20]],
+"the":[[0,4,3,5,2,5,5,3,4,6],[2,2,8,5],[4,5,19],[5,12,7],[6,7,7],[7,3,10,3],[9,2,15],[10,6,5,19],[11,2,3]],
+"them":[[9,34]],
+"this":[[0,1],[1,4],[5,5],[6,10],[7,6],[8,3]],
+"threads":[[0,48],[4,0,8],[10,34]],
+"to":[[4,3],[9,33],[10,5,24]],
+"txt":[[9,51]]
+});
@@ -0,0 +1,3 @@
+hatSearch.addTerms("u",{
+"use":[[4,1]]
+});
@@ -0,0 +1,4 @@
+hatSearch.addTerms("v",{
+"value":[[10,33]],
+"variance":[[9,18]]
+});
@@ -0,0 +1,8 @@
+hatSearch.addTerms("w",{
+"warning":[[4,29]],
+"website":[[11,6]],
+"which":[[0,33]],
+"with":[[0,52],[5,9],[8,7]],
+"word":[[0,61]],
+"words":[[0,54]]
+});
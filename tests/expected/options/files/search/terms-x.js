@@ -0,0 +1,3 @@
+hatSearch.addTerms("x",{
+"x":[[8,14],[9,6,8]]
+});
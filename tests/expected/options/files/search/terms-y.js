@@ -0,0 +1,3 @@
+hatSearch.addTerms("y",{
+"y":[[8,29]]
+});
@@ -0,0 +1,105 @@
+#!/bin/sh
+# Builds the documents in tests/manual and compares every output file, and
+# what is displayed, with the expected files in tests/expected. The documents
+# are copied to a temporary directory first, so that the bib cache and build
+# files are never written next to the tracked files. Each case is built
+# with -j 1 and with the default number of threads, and then built again
+# over its own output to check that a build with nothing changed gives the
+# same files.
+#
+# Usage: tests/run-tests.sh [hatdocs]
+#
+# To update the expected files after a change to the output that is wanted:
+#        tests/run-tests.sh --update [hatdocs]
+
+update=0
+if [ "$1" = "--update" ]; then
+	update=1
+	shift
+fi
+
+hatdocs=${1:-./hatdocs}
+[ -x "$hatdocs" ] || { echo "Cannot run: $hatdocs" >&2; exit 1; }
+case $hatdocs in /*) ;; *) hatdocs=$(pwd)/$hatdocs ;; esac
+
+tests=$(cd "$(dirname "$0")" && pwd)
+work=$(mktemp -d "${TMPDIR:-/tmp}/hatdocs-tests.XXXXXX") || exit 1
+trap 'rm -rf "$work"' EXIT
+
+# a fresh copy of the documents for each build, so that no case starts from the bib cache of another
+copyDocuments()
+{
+	rm -rf "$work/manual"
+	cp -R "$tests/manual" "$work/manual"
+}
+
+noFailed=0
+noRun=0
+
+# builds a case into a directory, $1 is the directory, the rest are options
+build()
+{
+	out=$1
+	shift
+	mkdir -p "$out/files"
+	copyDocuments
+	(cd "$work/manual" && "$hatdocs" -o "$out/files" "$@" -f footer.txt manual.hat refs.bib > "$out/stdout.txt" 2> "$out/stderr.txt")
+	echo $? > "$out/status.txt"
+	rm -f "$out/files/hatdocs.hatbuild"
+}
+
+# compares a build with the expected files
+check()
+{
+	name=$1
+	out=$2
+	noRun=$((noRun + 1))
+
+	if diff -r "$tests/expected/$caseName" "$out" > "$work/diff.txt"; then
+		echo "ok      $name"
+	else
+		echo "FAILED  $name"
+		head -n 40 "$work/diff.txt"
+		noFailed=$((noFailed + 1))
+	fi
+}
+
+# runs a case, $1 is the name and the rest are options
+runCase()
+{
+	caseName=$1
+	shift
+
+	if [ $update -eq 1 ]; then
+		rm -rf "$tests/expected/$caseName"
+		build "$tests/expected/$caseName" -j 1 "$@"
+		echo "updated $caseName"
+		return
+	fi
+
+	build "$work/$caseName-j1" -j 1 "$@"
+	check "$caseName -j 1" "$work/$caseName-j1"
+
+	build "$work/$caseName" "$@"
+	check "$caseName" "$work/$caseName"
+
+	# the stdout of a build with nothing changed lists the files as unchanged, so only the files are compared
+	(cd "$work/manual" && "$hatdocs" -o "$work/$caseName/files" "$@" -f footer.txt manual.hat refs.bib > /dev/null 2>&1)
+	rm -f "$work/$caseName/files/hatdocs.hatbuild"
+	noRun=$((noRun + 1))
+	if diff -r "$tests/expected/$caseName/files" "$work/$caseName/files" > "$work/diff.txt"; then
+		echo "ok      $caseName again"
+	else
+		echo "FAILED  $caseName again"
+		head -n 40 "$work/diff.txt"
+		noFailed=$((noFailed + 1))
+	fi
+}
+
+runCase default
+runCase options --split-tex --search --minify --shared-nav
+
+[ $update -eq 1 ] && exit 0
+
+echo "$((noRun - noFailed)) of $noRun passed"
+[ $noFailed -eq 0 ]